@@ -0,0 +1,67 @@
+#ifndef AVAILABILITYINDEX_H
+#define AVAILABILITYINDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Copies that are on the shelf, grouped by a title key (ISBN or normalized title), so
+// "any available copy of this title" is one hash lookup instead of a walk over every copy.
+//
+// Each key keeps a plain list of the library IDs that are available: four bytes per copy,
+// with no per-copy node. Listing and unlisting search only that key's list (a title's
+// copies, not the catalog) and removal swaps the last ID into the hole. A key whose list
+// empties is dropped. Not synchronized: the owner guards it.
+template <typename Key, typename Hash = std::hash<Key>>
+class AvailabilityIndex {
+public:
+    // Lists or unlists a copy under key
+    void Set(int libraryID, const Key& key, bool available) {
+        auto it = copies.find(key);
+        if (it == copies.end()) {
+            if (available) copies[key].push_back(libraryID);
+            return;
+        }
+        std::vector<int>& list = it->second;
+        auto listed = std::find(list.begin(), list.end(), libraryID);
+        if (available) {
+            if (listed == list.end()) list.push_back(libraryID);
+            return;
+        }
+        if (listed == list.end()) return;
+        *listed = list.back();
+        list.pop_back();
+        if (list.empty()) copies.erase(it);
+    }
+
+    // Lists many copies under one key. On a fresh key the IDs are taken as they are, so
+    // loading a title with thousands of copies is linear
+    void SetBulk(const Key& key, std::vector<int>&& libraryIDs) {
+        if (libraryIDs.empty()) return;
+        auto [it, added] = copies.try_emplace(key);
+        if (added) {
+            it->second = std::move(libraryIDs);
+            return;
+        }
+        for (int libraryID : libraryIDs) Set(libraryID, key, true);
+    }
+
+    // Library ID of some available copy under key, or 0
+    int Any(const Key& key) const {
+        auto it = copies.find(key);
+        return it == copies.end() ? 0 : it->second.back();
+    }
+
+    std::size_t Count(const Key& key) const {
+        auto it = copies.find(key);
+        return it == copies.end() ? 0 : it->second.size();
+    }
+
+private:
+    std::unordered_map<Key, std::vector<int>, Hash> copies; // key -> available library IDs
+};
+
+#endif // AVAILABILITYINDEX_H
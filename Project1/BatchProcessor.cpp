@@ -0,0 +1,114 @@
+#include "BatchProcessor.h"
+#include "MappedFile.h"
+#include <charconv>
+#include <iostream>
+#include <string_view>
+
+// helpers (file-local)
+namespace {
+
+const std::size_t MAX_FIELDS = 7;
+
+// Splits one line on tabs into fields; returns the field count (or MAX_FIELDS + 1 if there are more)
+std::size_t splitFields(std::string_view line, std::string_view (&fields)[MAX_FIELDS]) {
+    std::size_t count = 0;
+    while (true) {
+        std::size_t tab = line.find('\t');
+        if (count == MAX_FIELDS) return MAX_FIELDS + 1;
+        fields[count++] = line.substr(0, tab);
+        if (tab == std::string_view::npos) return count;
+        line.remove_prefix(tab + 1);
+    }
+}
+
+bool parseInt(std::string_view s, int& value) {
+    auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+    return result.ec == std::errc() && result.ptr == s.data() + s.size();
+}
+
+bool parseFloat(std::string_view s, float& value) {
+    auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+    return result.ec == std::errc() && result.ptr == s.data() + s.size();
+}
+
+} // namespace
+
+BatchProcessor::BatchProcessor(PatronsCollection& patrons, BooksCollection& books, LoansCollection& loans)
+    : patrons(patrons), books(books), loans(loans) {}
+
+bool BatchProcessor::Run(const std::string& path, std::int64_t now, Summary& summary) {
+    MappedFile file;
+    if (!file.Open(path)) return false;
+    std::string_view rest(file.Data(), file.Size());
+
+    loans.ExpireHolds(books, now);
+
+    std::size_t lineNumber = 0;
+    std::string_view fields[MAX_FIELDS];
+    while (!rest.empty()) {
+        std::size_t newline = rest.find('\n');
+        std::string_view line = rest.substr(0, newline);
+        rest.remove_prefix(newline == std::string_view::npos ? rest.size() : newline + 1);
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty() || line.front() == '#') continue;
+
+        std::size_t count = splitFields(line, fields);
+        std::string_view command = fields[0];
+        int a = 0, b = 0;
+        float amount = 0.0f;
+        ResultCode code = ResultCode::INVALID_FIELD;
+
+        if (command == "CHECKOUT" || command == "CHECKIN" || command == "RENEW") {
+            if (count == 3 && parseInt(fields[1], a) && parseInt(fields[2], b)) {
+                if (command == "CHECKOUT") code = loans.Checkout(patrons, books, a, b, now);
+                else if (command == "CHECKIN") code = loans.Checkin(patrons, books, a, b, now);
+                else code = loans.Renew(patrons, books, a, b, now);
+            }
+        } else if (command == "LOST") {
+            if (count == 2 && parseInt(fields[1], a)) code = loans.MarkLost(books, a);
+        } else if (command == "HOLD") {
+            int priority = 0;
+            if ((count == 3 || (count == 4 && parseInt(fields[3], priority) && priority >= 0
+                                && priority < HoldQueues::PRIORITY_LEVELS))
+                && parseInt(fields[1], a) && parseInt(fields[2], b)) {
+                code = loans.PlaceHold(patrons, books, a, b, now, priority);
+            }
+        } else if (command == "CANCELHOLD") {
+            if (count == 3 && parseInt(fields[1], a) && parseInt(fields[2], b)) code = loans.CancelHold(patrons, books, a, b, now);
+        } else if (command == "PAYFINE") {
+            if (count == 3 && parseInt(fields[1], a) && parseFloat(fields[2], amount)) code = patrons.PayFine(a, amount);
+        } else if (command == "ADDPATRON") {
+            if (count == 3) code = patrons.AddPatron(std::string(fields[1]), std::string(fields[2]));
+        } else if (command == "ADDBOOK") {
+            int material = Books::BOOK;
+            if ((count == 6 || (count == 7 && parseInt(fields[6], material) && material >= 0 && material < Books::MATERIAL_COUNT))
+                && parseInt(fields[4], a) && BooksCollection::IsValidCostText(fields[5]) && parseFloat(fields[5], amount)) {
+                code = books.AddBook(std::string(fields[1]), std::string(fields[2]), std::string(fields[3]), a, amount,
+                                     Books::IN, static_cast<Books::Material>(material));
+            }
+        }
+
+        ++summary.processed;
+        ++summary.byCode[static_cast<std::size_t>(code)];
+        if (code != ResultCode::OK && summary.failures.size() < MAX_REPORTED_FAILURES) {
+            summary.failures.push_back({ lineNumber, code, std::string(line) });
+        }
+    }
+    return true;
+}
+
+void BatchProcessor::PrintSummary(const Summary& summary) {
+    std::cout << "Processed " << summary.processed << " transaction(s).\n";
+    for (int i = 0; i < RESULT_CODE_COUNT; ++i) {
+        if (summary.byCode[i] > 0) {
+            std::cout << "  " << ResultCodeName(static_cast<ResultCode>(i)) << ": " << summary.byCode[i] << "\n";
+        }
+    }
+    if (!summary.failures.empty()) {
+        std::cout << "First failures:\n";
+        for (const Failure& failure : summary.failures) {
+            std::cout << "  line " << failure.line << " (" << ResultCodeName(failure.code) << "): " << failure.text << "\n";
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ResultCode.h"
+#include "PatronsCollection.h"
+#include "BooksCollection.h"
+#include "LoansCollection.h"
+
+// Runs a file of circulation transactions through the core API without prompting.
+//
+// One transaction per line, fields separated by tabs; blank lines and lines starting
+// with '#' are ignored:
+//   CHECKOUT  patronID  bookID
+//   CHECKIN   patronID  bookID
+//   RENEW     patronID  bookID
+//   LOST      bookID
+//   HOLD      patronID  bookID  [priority 0 regular / 1 priority]
+//   CANCELHOLD patronID holdID
+//   PAYFINE   patronID  amount
+//   ADDPATRON first     last
+//   ADDBOOK   author    title  isbn  libraryID  cost  [material 0 book / 1 DVD / 2 magazine / 3 audiobook]
+// Holds whose pickup deadline has passed are released before the first line.
+// Unknown commands and malformed fields count as INVALID_FIELD. The file is
+// memory-mapped and tokenized in place; nothing is printed per line.
+class BatchProcessor {
+public:
+    static const std::size_t MAX_REPORTED_FAILURES = 20;
+
+    struct Failure {
+        std::size_t line;
+        ResultCode code;
+        std::string text;
+    };
+
+    struct Summary {
+        std::size_t processed = 0;
+        std::array<std::size_t, RESULT_CODE_COUNT> byCode{};
+        std::vector<Failure> failures; // the first MAX_REPORTED_FAILURES failed lines
+    };
+
+    BatchProcessor(PatronsCollection& patrons, BooksCollection& books, LoansCollection& loans);
+
+    // Applies every transaction in the file; returns false if it cannot be read.
+    // now is used as the clock for every due date in the run.
+    bool Run(const std::string& path, std::int64_t now, Summary& summary);
+
+    // Prints the totals per result code and the recorded failures
+    static void PrintSummary(const Summary& summary);
+
+private:
+    PatronsCollection& patrons;
+    BooksCollection& books;
+    LoansCollection& loans;
+};
+
+#endif // BATCHPROCESSOR_H
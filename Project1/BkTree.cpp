@@ -0,0 +1,58 @@
+#include "BkTree.h"
+#include "EditDistance.h"
+#include <algorithm>
+
+void BkTree::Add(const std::string& word) {
+    auto known = index.find(word);
+    if (known != index.end()) {
+        ++nodes[known->second].count;
+        return;
+    }
+
+    const std::uint32_t added = static_cast<std::uint32_t>(nodes.size());
+    if (!nodes.empty()) {
+        EditDistance fromWord(word);
+        std::uint32_t at = 0;
+        while (true) {
+            const int distance = fromWord.To(nodes[at].word);
+            auto& children = nodes[at].children;
+            auto child = std::find_if(children.begin(), children.end(),
+                                      [distance](const std::pair<int, std::uint32_t>& c) { return c.first == distance; });
+            if (child == children.end()) {
+                children.emplace_back(distance, added);
+                break;
+            }
+            at = child->second;
+        }
+    }
+    nodes.push_back(Node{ word, 1, {} });
+    index.emplace(word, added);
+}
+
+void BkTree::Remove(const std::string& word) {
+    auto known = index.find(word);
+    if (known != index.end() && nodes[known->second].count > 0) --nodes[known->second].count;
+}
+
+std::vector<BkTree::Match> BkTree::Find(std::string_view word, int maxDistance, std::size_t limit) const {
+    std::vector<Match> matches;
+    if (nodes.empty() || limit == 0) return matches;
+
+    EditDistance fromWord(word);
+    std::vector<std::uint32_t> pending{ 0 };
+    while (!pending.empty()) {
+        const Node& node = nodes[pending.back()];
+        pending.pop_back();
+        const int distance = fromWord.To(node.word);
+        if (distance <= maxDistance && node.count > 0) matches.push_back(Match{ &node.word, distance });
+        for (const auto& child : node.children) {
+            if (child.first >= distance - maxDistance && child.first <= distance + maxDistance) pending.push_back(child.second);
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.distance != b.distance ? a.distance < b.distance : *a.word < *b.word;
+    });
+    if (matches.size() > limit) matches.resize(limit);
+    return matches;
+}
@@ -0,0 +1,44 @@
+#ifndef BKTREE_H
+#define BKTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Burkhard-Keller tree over a multiset of words, for "every word within k edits" queries.
+//
+// Each child hangs off its parent by its edit distance to the parent, so by the triangle
+// inequality a search for words within k of q at distance d from a node only descends
+// into children labelled d-k..d+k. Words are counted; a word whose count drops to zero
+// stays in place as a routing node and is no longer reported.
+class BkTree {
+public:
+    struct Match {
+        const std::string* word; // valid until the next Add
+        int distance;
+    };
+
+    void Add(const std::string& word);    // one more occurrence
+    void Remove(const std::string& word); // one fewer occurrence
+
+    // Words within maxDistance of word, closest first (ties alphabetically), at most limit
+    std::vector<Match> Find(std::string_view word, int maxDistance, std::size_t limit) const;
+
+    std::size_t Size() const { return index.size(); } // distinct words ever added
+
+private:
+    struct Node {
+        std::string word;
+        std::uint32_t count = 0;
+        std::vector<std::pair<int, std::uint32_t>> children; // (distance to this word, node)
+    };
+
+    std::vector<Node> nodes; // nodes[0] is the root
+    std::unordered_map<std::string, std::uint32_t> index;
+};
+
+#endif // BKTREE_H
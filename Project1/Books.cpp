@@ -1,18 +1,80 @@
 #include "Books.h"
 
-Books::Books(std::string author, std::string title, const std::string& isbn, int libraryID, float cost, BookStatus status)
-    : author(author), title(title), isbn(isbn), libraryID(libraryID), cost(cost), bookStatus(status) {}
+Books::Books(std::string_view author, std::string_view title, std::string_view isbn, int libraryID, float cost,
+             BookStatus status, Material material)
+    : work(WorkTable::Intern(author, title, PackISBN(isbn))), libraryID(libraryID), cost(cost), material(material),
+      bookStatus(status) {}
 
-std::string Books::getAuthor() const { return author; }
-std::string Books::getTitle() const { return title; }
-std::string Books::getISBN() const { return isbn; }
+Books::Books(const Work* work, int libraryID, float cost, BookStatus status, Material material)
+    : work(work), libraryID(libraryID), cost(cost), material(material), bookStatus(status) {
+    WorkTable::Acquire(work);
+}
+
+Books::Books(const Books& other)
+    : work(other.work), libraryID(other.libraryID), cost(other.cost), material(other.material),
+      bookStatus(other.bookStatus.load()) {
+    WorkTable::Acquire(work);
+}
+
+Books::Books(Books&& other) noexcept
+    : work(other.work), libraryID(other.libraryID), cost(other.cost), material(other.material),
+      bookStatus(other.bookStatus.load()) {
+    WorkTable::Acquire(work);
+}
+
+Books::~Books() { WorkTable::Release(work); }
+
+Books& Books::operator=(const Books& other) {
+    if (work != other.work) {
+        WorkTable::Acquire(other.work);
+        WorkTable::Release(work);
+        work = other.work;
+    }
+    libraryID = other.libraryID;
+    cost = other.cost;
+    material = other.material;
+    bookStatus = other.bookStatus.load();
+    return *this;
+}
+
+Books& Books::operator=(Books&& other) noexcept {
+    return *this = static_cast<const Books&>(other); // nothing to steal
+}
+
+std::uint64_t Books::PackISBN(std::string_view isbn) {
+    std::uint64_t packed = 0;
+    for (char c : isbn) packed = packed * 10 + static_cast<std::uint64_t>(c - '0');
+    return packed;
+}
+
+const Work* Books::getWork() const { return work; }
+std::string_view Books::getAuthor() const { return work->author; }
+std::string_view Books::getTitle() const { return work->title; }
+
+std::string Books::getISBN() const { return UnpackISBN(work->isbn); }
+
+std::string Books::UnpackISBN(std::uint64_t packed) {
+    std::string digits(10, '0');
+    for (std::size_t i = digits.size(); i-- > 0 && packed != 0; packed /= 10) digits[i] = static_cast<char>('0' + packed % 10);
+    return digits;
+}
+
+std::uint64_t Books::getPackedISBN() const { return work->isbn; }
 int Books::getLibraryID() const { return libraryID; }
 float Books::getCost() const { return cost; }
 Books::BookStatus Books::getCurrentBookStatus() const { return bookStatus; }
+Books::Material Books::getMaterial() const { return material; }
+
+void Books::setAuthor(std::string_view author) { setWork(WorkTable::Intern(author, work->title, work->isbn)); }
+void Books::setTitle(std::string_view title) { setWork(WorkTable::Intern(work->author, title, work->isbn)); }
+void Books::setISBN(std::string_view isbn) { setWork(WorkTable::Intern(work->author, work->title, PackISBN(isbn))); }
 
-void Books::setAuthor(const std::string& author) { this->author = author; }
-void Books::setTitle(const std::string& title) { this->title = title; }
-void Books::setISBN(const std::string& isbn) { this->isbn = isbn; }
+// Takes over the reference Intern returned and drops the one to the old work
+void Books::setWork(const Work* next) {
+    WorkTable::Release(work);
+    work = next;
+}
 void Books::setLibraryID(int libraryID) { this->libraryID = libraryID; }
 void Books::setCost(float cost) { this->cost = cost; }
 void Books::setCurrentBookStatus(BookStatus status) { this->bookStatus = status; }
+void Books::setMaterial(Material material) { this->material = material; }
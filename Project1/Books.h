@@ -1,35 +1,65 @@
 #ifndef BOOKS_H
 #define BOOKS_H
 //wawa
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include "WorkTable.h"
 
+// One physical copy (item) of a title. The bibliographic fields (author, title, ISBN) live
+// in a shared Work record (see WorkTable), so every copy of a title points at the same one
+// and a copy itself only holds its library ID, cost, material and status. Accessors return
+// views into the work, so listing loops do not copy.
 class Books {
 public:
-    enum BookStatus { IN, OUT, LOST };
+    enum BookStatus { IN, OUT, LOST, ON_HOLD }; // ON_HOLD: set aside for a patron's hold
 
-    Books(std::string author, std::string title, const std::string& isbn, int libraryID, float cost, BookStatus status = IN);
+    // Kind of item, which sets its loan period (see LoansCollection::SetLoanDays)
+    enum Material { BOOK, DVD, MAGAZINE, AUDIOBOOK };
+    static const int MATERIAL_COUNT = AUDIOBOOK + 1;
 
-    std::string getAuthor() const;
-    std::string getTitle() const;
-    std::string getISBN() const;
+    Books(std::string_view author, std::string_view title, std::string_view isbn, int libraryID, float cost,
+          BookStatus status = IN, Material material = BOOK);
+    Books(const Work* work, int libraryID, float cost, BookStatus status = IN, Material material = BOOK);
+    Books(const Books& other);
+    Books(Books&& other) noexcept;
+    ~Books();
+    Books& operator=(const Books& other);
+    Books& operator=(Books&& other) noexcept;
+
+    const Work* getWork() const;
+    std::string_view getAuthor() const;
+    std::string_view getTitle() const;
+    std::string getISBN() const;           // 10 digits, zero-padded; short enough to need no allocation
+    std::uint64_t getPackedISBN() const;
     int getLibraryID() const;
     float getCost() const;
     BookStatus getCurrentBookStatus() const;
+    Material getMaterial() const;
 
-    void setAuthor(const std::string& author);
-    void setTitle(const std::string& title);
-    void setISBN(const std::string& isbn);
+    // setAuthor, setTitle and setISBN move this copy to another work
+    void setAuthor(std::string_view author);
+    void setTitle(std::string_view title);
+    void setISBN(std::string_view isbn);
     void setLibraryID(int libraryID);
     void setCost(float cost);
     void setCurrentBookStatus(BookStatus status);
+    void setMaterial(Material material);
+
+    // Packs a 10-digit ISBN into an integer; the caller validates the digits
+    static std::uint64_t PackISBN(std::string_view isbn);
+    static std::string UnpackISBN(std::uint64_t packed); // back to 10 digits
 
 private:
-    std::string author;
-    std::string title;
-    std::string isbn;
+    void setWork(const Work* next);
+
+    const Work* work; // shared; this copy holds one reference
     int libraryID;
     float cost;
-    BookStatus bookStatus;
+    Material material;
+    // Atomic because lock-free catalog readers may look at it while a checkout changes it
+    std::atomic<BookStatus> bookStatus;
 };
 
 #endif // BOOKS_H
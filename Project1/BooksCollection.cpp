@@ -1,10 +1,15 @@
 #include "BooksCollection.h"
+#include "Journal.h"
+#include "ReportWriter.h"
 #include <iostream>
 #include <string>
 #include <limits>
 #include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 
 // helpers (file-local)
 static std::string trim(const std::string& s) {
@@ -15,17 +20,268 @@ static std::string trim(const std::string& s) {
     return s.substr(start, end - start);
 }
 
-static std::string toLower(const std::string& s) {
-    std::string out;
-    out.reserve(s.size());
-    for (unsigned char c : s) out.push_back(static_cast<char>(std::tolower(c)));
-    return out;
+// Key used by the title index: case-folded and trimmed, matching FindBookByTitle
+static std::string titleKey(std::string_view title) {
+    std::size_t start = 0;
+    while (start < title.size() && std::isspace(static_cast<unsigned char>(title[start]))) ++start;
+    std::size_t end = title.size();
+    while (end > start && std::isspace(static_cast<unsigned char>(title[end - 1]))) --end;
+    std::string key;
+    key.reserve(end - start);
+    for (std::size_t i = start; i < end; ++i) key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(title[i]))));
+    return key;
+}
+
+std::string BooksCollection::NormalizeTitle(std::string_view title) {
+    return titleKey(title);
+}
+
+// Index buckets are immutable once published: changes copy the bucket and publish the copy
+template <typename Buckets, typename Key, typename T>
+static void addToBucket(Buckets& index, const Key& key, T* item) {
+    const std::vector<T*>* current = index.Find(key);
+    std::vector<T*> items = current ? *current : std::vector<T*>();
+    items.push_back(item);
+    index.Set(key, std::move(items));
+}
+
+// Removes one item from an index bucket, dropping the bucket once it is empty
+template <typename Buckets, typename Key, typename T>
+static void eraseFromBucket(Buckets& index, const Key& key, T* item) {
+    const std::vector<T*>* current = index.Find(key);
+    if (!current) return;
+    std::vector<T*> items = *current;
+    items.erase(std::remove(items.begin(), items.end(), item), items.end());
+    if (items.empty()) index.Erase(key);
+    else index.Set(key, std::move(items));
+}
+
+// Bulk form of addToBucket: publishes each touched bucket once rather than once per item
+template <typename Buckets, typename Key, typename T>
+static void addToBuckets(Buckets& index, std::unordered_map<Key, std::vector<T*>>& added) {
+    for (auto& [key, items] : added) {
+        const std::vector<T*>* current = index.Find(key);
+        if (current) items.insert(items.begin(), current->begin(), current->end());
+        index.Set(key, std::move(items));
+    }
 }
 
 BooksCollection::BooksCollection() {}
-BooksCollection::~BooksCollection() {
-    for (Books* b : booksList) delete b;
-    booksList.clear();
+BooksCollection::~BooksCollection() {} // booksList owns and frees the records
+
+void BooksCollection::IndexBook(SlabHandle handle, std::string_view key) {
+    Books* book = booksList.Get(handle);
+    booksByID.Set(book->getLibraryID(), BookRef{ book, handle });
+    addToBucket(booksByISBN, book->getPackedISBN(), book);
+    std::string title = key.empty() ? titleKey(book->getTitle()) : std::string(key);
+    {
+        const bool available = book->getCurrentBookStatus() == Books::IN;
+        std::unique_lock<std::shared_mutex> lock(availabilityMutex);
+        availableByISBN.Set(book->getLibraryID(), book->getPackedISBN(), available);
+        availableByTitle.Set(book->getLibraryID(), title, available);
+    }
+    addToBucket(booksByTitle, std::move(title), book);
+    std::unique_lock<std::shared_mutex> search(searchMutex);
+    searchIndex.Add(book->getLibraryID(), book->getTitle(), book->getAuthor());
+}
+
+void BooksCollection::UnindexBook(SlabHandle handle) {
+    Books* book = booksList.Get(handle);
+    const BookRef* byID = booksByID.Find(book->getLibraryID());
+    const std::string title = titleKey(book->getTitle());
+    {
+        // Unlist the copy under its old keys, unless a new version is already listed there
+        const Books* current = byID && byID->book != book ? byID->book : nullptr;
+        std::unique_lock<std::shared_mutex> lock(availabilityMutex);
+        if (!current || current->getPackedISBN() != book->getPackedISBN())
+            availableByISBN.Set(book->getLibraryID(), book->getPackedISBN(), false);
+        if (!current || titleKey(current->getTitle()) != title)
+            availableByTitle.Set(book->getLibraryID(), title, false);
+    }
+    if (byID && byID->book == book) { // deleted, not replaced by a new version
+        booksByID.Erase(book->getLibraryID());
+        std::unique_lock<std::shared_mutex> search(searchMutex);
+        searchIndex.Remove(book->getLibraryID());
+    }
+    eraseFromBucket(booksByISBN, book->getPackedISBN(), book);
+    eraseFromBucket(booksByTitle, title, book);
+}
+
+// The new version is indexed before the old one is unindexed, so a concurrent lookup
+// by ID always finds one of the two
+Books* BooksCollection::PublishVersion(Books* book, Books&& updated) {
+    SlabHandle oldHandle = HandleOf(book);
+    SlabHandle newHandle = booksList.Emplace(std::move(updated));
+    IndexBook(newHandle);
+    UnindexBook(oldHandle);
+    retiredBooks.Retire([this, oldHandle] { booksList.Erase(oldHandle); });
+    return booksList.Get(newHandle);
+}
+
+void BooksCollection::RetireBook(SlabHandle handle) {
+    UnindexBook(handle);
+    retiredBooks.Retire([this, handle] { booksList.Erase(handle); });
+}
+
+SlabHandle BooksCollection::HandleOf(const Books* book) const {
+    const BookRef* ref = booksByID.Find(book->getLibraryID());
+    return ref && ref->book == book ? ref->handle : SlabHandle{};
+}
+
+bool BooksCollection::IsValidText(std::string_view s) {
+    bool hasLetter = false;
+    for (unsigned char ch : s) {
+        if (std::isalpha(ch)) hasLetter = true;
+        else if (!std::isspace(ch)) return false;
+    }
+    return hasLetter;
+}
+
+bool BooksCollection::IsValidISBN(std::string_view isbn) {
+    if (isbn.size() != 10) return false;
+    for (unsigned char c : isbn) if (!std::isdigit(c)) return false;
+    return true;
+}
+
+bool BooksCollection::IsValidLibraryID(int libraryID) {
+    return libraryID > 0 && libraryID <= 99999999;
+}
+
+bool BooksCollection::IsValidCost(float cost) {
+    return std::isfinite(cost) && cost >= 0.0f;
+}
+
+// Plain decimals only: no sign, exponent, inf or nan, which number parsers would accept
+bool BooksCollection::IsValidCostText(std::string_view s) {
+    int dots = 0;
+    int digits = 0;
+    for (unsigned char c : s) {
+        if (std::isdigit(c)) ++digits;
+        else if (c != '.' || ++dots > 1) return false;
+    }
+    return digits > 0;
+}
+
+ResultCode BooksCollection::AddBook(const std::string& author, const std::string& title, const std::string& isbn,
+                                    int libraryID, float cost, Books::BookStatus status, Books::Material material) {
+    if (!IsValidText(author) || !IsValidText(title) || !IsValidISBN(isbn)
+        || !IsValidLibraryID(libraryID) || !IsValidCost(cost)) {
+        return ResultCode::INVALID_FIELD;
+    }
+    std::lock_guard<std::mutex> record(RecordLock(libraryID));
+    Books* book;
+    {
+        std::unique_lock<std::shared_mutex> lock(booksMutex);
+        if (LookupID(libraryID)) return ResultCode::DUPLICATE_ID;
+        SlabHandle handle = booksList.Emplace(author, title, isbn, libraryID, cost, status, material);
+        IndexBook(handle);
+        book = booksList.Get(handle);
+    }
+    if (journal) {
+        journal->LogBook(*book);
+        journal->Commit();
+    }
+    return ResultCode::OK;
+}
+
+bool BooksCollection::InsertBook(const std::string& author, const std::string& title, const std::string& isbn,
+                                 int libraryID, float cost, Books::BookStatus status, Books::Material material,
+                                 std::string_view key) {
+    std::unique_lock<std::shared_mutex> lock(booksMutex);
+    if (LookupID(libraryID)) return false;
+    IndexBook(booksList.Emplace(author, title, isbn, libraryID, cost, status, material), key);
+    return true;
+}
+
+void BooksCollection::UpsertBook(const std::string& author, const std::string& title, const std::string& isbn,
+                                 int libraryID, float cost, Books::BookStatus status, Books::Material material) {
+    std::unique_lock<std::shared_mutex> lock(booksMutex);
+    Books* book = LookupID(libraryID);
+    if (!book) {
+        IndexBook(booksList.Emplace(author, title, isbn, libraryID, cost, status, material));
+        return;
+    }
+    PublishVersion(book, Books(author, title, isbn, libraryID, cost, status, material));
+}
+
+bool BooksCollection::RemoveBook(int libraryID) {
+    std::unique_lock<std::shared_mutex> lock(booksMutex);
+    const BookRef* ref = booksByID.Find(libraryID);
+    if (!ref) return false;
+    RetireBook(ref->handle);
+    return true;
+}
+
+void BooksCollection::SetJournal(Journal* j) { journal = j; }
+
+void BooksCollection::InsertBooksBulk(std::vector<Books>& newBooks, std::vector<std::string>& titleKeys) {
+    std::unique_lock<std::shared_mutex> lock(booksMutex);
+    std::vector<SlabHandle> handles;
+    handles.reserve(newBooks.size());
+    const std::size_t total = booksList.Size() + newBooks.size();
+    booksList.Reserve(total);
+    booksByID.Reserve(total);
+    booksByISBN.Reserve(total);
+    booksByTitle.Reserve(total);
+    for (Books& book : newBooks) handles.push_back(booksList.Emplace(std::move(book)));
+
+    // Each index is only written by its own thread; the records are only read
+    std::thread byID([&] {
+        for (SlabHandle handle : handles) {
+            Books* book = booksList.Get(handle);
+            booksByID.Set(book->getLibraryID(), BookRef{ book, handle });
+        }
+    });
+    std::thread bySearchWords([&] {
+        std::vector<CatalogSearchIndex::Entry> entries;
+        entries.reserve(handles.size());
+        for (SlabHandle handle : handles) {
+            const Books* book = booksList.Get(handle);
+            entries.push_back({ book->getLibraryID(), book->getTitle(), book->getAuthor() });
+        }
+        std::unique_lock<std::shared_mutex> search(searchMutex);
+        searchIndex.AddBulk(std::move(entries));
+    });
+    std::thread byISBN([&] {
+        std::unordered_map<std::uint64_t, std::vector<Books*>> added;
+        for (SlabHandle handle : handles) {
+            Books* book = booksList.Get(handle);
+            added[book->getPackedISBN()].push_back(book);
+        }
+        addToBuckets(booksByISBN, added);
+    });
+    std::thread byAvailableISBN([&] {
+        std::unordered_map<std::uint64_t, std::vector<int>> available;
+        for (SlabHandle handle : handles) {
+            const Books* book = booksList.Get(handle);
+            if (book->getCurrentBookStatus() == Books::IN) available[book->getPackedISBN()].push_back(book->getLibraryID());
+        }
+        std::unique_lock<std::shared_mutex> lock(availabilityMutex);
+        for (auto& [isbn, ids] : available) availableByISBN.SetBulk(isbn, std::move(ids));
+    });
+    std::unordered_map<std::string, std::vector<Books*>> addedTitles;
+    for (std::size_t i = 0; i < handles.size(); ++i) addedTitles[std::move(titleKeys[i])].push_back(booksList.Get(handles[i]));
+    {
+        std::unique_lock<std::shared_mutex> lock(availabilityMutex);
+        for (const auto& [title, books] : addedTitles) {
+            std::vector<int> ids;
+            for (const Books* book : books) if (book->getCurrentBookStatus() == Books::IN) ids.push_back(book->getLibraryID());
+            availableByTitle.SetBulk(title, std::move(ids));
+        }
+    }
+    addToBuckets(booksByTitle, addedTitles);
+    byID.join();
+    byISBN.join();
+    bySearchWords.join();
+    byAvailableISBN.join();
+}
+
+void BooksCollection::Reserve(std::size_t count) {
+    std::unique_lock<std::shared_mutex> lock(booksMutex);
+    booksList.Reserve(count);
+    booksByID.Reserve(count);
+    booksByISBN.Reserve(count);
+    booksByTitle.Reserve(count);
 }
 
 void BooksCollection::AddBook() {
@@ -38,21 +294,11 @@ void BooksCollection::AddBook() {
     int statusChoice = 0;
 
     // Author: allow letters and spaces only
-    auto isAlphaSpaceOnly = [](const std::string& s) {
-        if (s.empty()) return false;
-        bool hasLetter = false;
-        for (unsigned char ch : s) {
-            if (std::isalpha(ch)) hasLetter = true;
-            if (!(std::isalpha(ch) || std::isspace(ch))) return false;
-        }
-        return hasLetter;
-    };
-
     while (true) {
         std::cout << "Enter author: ";
         if (!std::getline(std::cin >> std::ws, author)) return;
         author = trim(author);
-        if (!isAlphaSpaceOnly(author)) {
+        if (!IsValidText(author)) {
             std::cout << "Please enter letters and spaces only for the author." << std::endl;
             continue;
         }
@@ -64,7 +310,7 @@ void BooksCollection::AddBook() {
         std::cout << "Enter title: ";
         if (!std::getline(std::cin >> std::ws, title)) return;
         title = trim(title);
-        if (!isAlphaSpaceOnly(title)) {
+        if (!IsValidText(title)) {
             std::cout << "Please enter letters and spaces only for the title." << std::endl;
             continue;
         }
@@ -78,10 +324,7 @@ void BooksCollection::AddBook() {
         if (!std::getline(std::cin, line)) return;
         line = trim(line);
         if (line.empty()) continue;
-        // Validate exactly 10 digits
-        bool ok = (line.size() == 10);
-        for (char c : line) if (!std::isdigit(static_cast<unsigned char>(c))) { ok = false; break; }
-        if (!ok) {
+        if (!IsValidISBN(line)) {
             std::cout << "Please write 10 numbers" << std::endl;
             continue;
         }
@@ -103,6 +346,7 @@ void BooksCollection::AddBook() {
         try {
             libraryID = std::stoi(line);
             if (libraryID <= 0) { std::cout << "Please enter a positive integer for Library ID" << std::endl; continue; }
+            if (HasBookID(libraryID)) { std::cout << "A book with that Library ID already exists" << std::endl; continue; }
             break;
         } catch (...) {
             std::cout << "Please enter a positive integer for Library ID" << std::endl;
@@ -114,19 +358,10 @@ void BooksCollection::AddBook() {
         if (!std::getline(std::cin, line)) return;
         line = trim(line);
         if (line.empty()) continue;
-        // Validate positive decimal number with optional one dot
-        bool ok = false;
-        int dots = 0;
-        int digits = 0;
-        for (unsigned char c : line) {
-            if (std::isdigit(c)) { ok = true; ++digits; }
-            else if (c == '.') { ++dots; if (dots > 1) { ok = false; break; } }
-            else { ok = false; break; }
-        }
-        if (!ok || digits == 0) { std::cout << "Please enter a non-negative number" << std::endl; continue; }
+        if (!IsValidCostText(line)) { std::cout << "Please enter a non-negative number" << std::endl; continue; }
         try {
             cost = std::stof(line);
-            if (cost < 0.0f) { std::cout << "Please enter a non-negative number" << std::endl; continue; }
+            if (!IsValidCost(cost)) { std::cout << "Please enter a non-negative number" << std::endl; continue; }
             break;
         } catch (...) {
             std::cout << "Please enter a non-negative number" << std::endl;
@@ -147,20 +382,44 @@ void BooksCollection::AddBook() {
 
     Books::BookStatus status = static_cast<Books::BookStatus>(statusChoice);
 
-    Books* newBook = new Books(author, title, isbn, libraryID, cost, status);
-    booksList.push_back(newBook);
+    int materialChoice = Books::BOOK;
+    while (true) {
+        std::cout << "Select material (0 = Book, 1 = DVD, 2 = Magazine, 3 = Audiobook; Enter for Book): ";
+        if (!std::getline(std::cin, line)) return;
+        line = trim(line);
+        if (line.empty()) break;
+        try {
+            materialChoice = std::stoi(line);
+            if (materialChoice >= 0 && materialChoice < Books::MATERIAL_COUNT) break;
+        } catch (...) {}
+        std::cout << "Invalid choice. Enter 0, 1, 2, or 3.\n";
+    }
 
-    std::cout << "Book added: \"" << title << "\" by " << author << '\n';
+    // Another terminal may have taken the ID since it was checked above
+    switch (AddBook(author, title, isbn, libraryID, cost, status, static_cast<Books::Material>(materialChoice))) {
+        case ResultCode::OK:
+            std::cout << "Book added: \"" << title << "\" by " << author << '\n';
+            break;
+        case ResultCode::DUPLICATE_ID:
+            std::cout << "A book with that Library ID already exists. Book not added.\n";
+            break;
+        default:
+            std::cout << "Invalid book details. Book not added.\n";
+    }
 }
 
 void BooksCollection::EditBook() {
-    Books* book = PromptForSearchMechanism();
-    if (!book) {
-        std::cout << "Book not found.\n";
-        return;
+    const int libraryID = PromptForSearchMechanism();
+    {
+        Epoch::ReadGuard guard; // keeps the looked-up book alive while its title is printed
+        const Books* book = FindBookByID(libraryID);
+        if (!book) {
+            std::cout << "Book not found.\n";
+            return;
+        }
+        std::cout << "Editing Book: " << book->getTitle() << "\n";
     }
 
-    std::cout << "Editing Book: " << book->getTitle() << "\n";
     std::cout << "Select the attribute to edit: \n";
     std::cout << "1. Title\n";
     std::cout << "2. Author\n";
@@ -176,70 +435,31 @@ void BooksCollection::EditBook() {
     }
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear the newline character from the buffer
 
+    // The new value is read before the record is locked, so a terminal left at a prompt
+    // does not hold up circulation on the books sharing its lock stripe
+    std::string newText;
+    float newCost = 0.0f;
     switch (choice) {
-        case 1: {
-            // Validate title: letters and spaces only
-            auto isAlphaSpaceOnly = [](const std::string& s) {
-                if (s.empty()) return false;
-                bool hasLetter = false;
-                for (unsigned char ch : s) {
-                    if (std::isalpha(ch)) hasLetter = true;
-                    if (!(std::isalpha(ch) || std::isspace(ch))) return false;
-                }
-                return hasLetter;
-            };
-
-            std::string newTitle;
-            while (true) {
-                std::cout << "Enter new title: ";
-                if (!std::getline(std::cin, newTitle)) { std::cout << "Invalid title. No change made.\n"; break; }
-                newTitle = trim(newTitle);
-                if (!isAlphaSpaceOnly(newTitle)) {
-                    std::cout << "Please enter letters and spaces only for the title." << std::endl;
-                    continue;
-                }
-                book->setTitle(newTitle);
-                break;
-            }
-            break;
-        }
+        case 1:
         case 2: {
-            // Validate author: letters and spaces only
-            auto isAlphaSpaceOnly = [](const std::string& s) {
-                if (s.empty()) return false;
-                bool hasLetter = false;
-                for (unsigned char ch : s) {
-                    if (std::isalpha(ch)) hasLetter = true;
-                    if (!(std::isalpha(ch) || std::isspace(ch))) return false;
-                }
-                return hasLetter;
-            };
-
-            std::string newAuthor;
+            // Validate title/author: letters and spaces only
+            const char* field = choice == 1 ? "title" : "author";
             while (true) {
-                std::cout << "Enter new author: ";
-                if (!std::getline(std::cin, newAuthor)) { std::cout << "Invalid author. No change made.\n"; break; }
-                newAuthor = trim(newAuthor);
-                if (!isAlphaSpaceOnly(newAuthor)) {
-                    std::cout << "Please enter letters and spaces only for the author." << std::endl;
-                    continue;
-                }
-                book->setAuthor(newAuthor);
-                break;
+                std::cout << "Enter new " << field << ": ";
+                if (!std::getline(std::cin, newText)) { std::cout << "Invalid " << field << ". No change made.\n"; return; }
+                newText = trim(newText);
+                if (IsValidText(newText)) break;
+                std::cout << "Please enter letters and spaces only for the " << field << "." << std::endl;
             }
             break;
         }
         case 3: {
-            std::string newISBN;
             std::cout << "Enter new ISBN (10 digits): ";
-            if (!std::getline(std::cin, newISBN)) { std::cout << "Invalid ISBN. No change made.\n"; break; }
-            newISBN = trim(newISBN);
-            bool ok = (newISBN.size() == 10);
-            for (char c : newISBN) if (!std::isdigit(static_cast<unsigned char>(c))) { ok = false; break; }
-            if (!ok) {
+            if (!std::getline(std::cin, newText)) { std::cout << "Invalid ISBN. No change made.\n"; return; }
+            newText = trim(newText);
+            if (!IsValidISBN(newText)) {
                 std::cout << "Please write 10 numbers" << std::endl;
-            } else {
-                book->setISBN(newISBN);
+                return;
             }
             break;
         }
@@ -248,7 +468,7 @@ void BooksCollection::EditBook() {
             std::string costLine;
             while (true) {
                 std::cout << "Enter new cost: ";
-                if (!std::getline(std::cin, costLine)) { std::cout << "Invalid cost. No change made.\n"; break; }
+                if (!std::getline(std::cin, costLine)) { std::cout << "Invalid cost. No change made.\n"; return; }
                 costLine = trim(costLine);
                 if (costLine.empty()) { std::cout << "Please enter a positive number" << std::endl; continue; }
                 bool ok = false;
@@ -261,9 +481,8 @@ void BooksCollection::EditBook() {
                 }
                 if (!ok || digits == 0) { std::cout << "Please enter a non-negative number" << std::endl; continue; }
                 try {
-                    float newCost = std::stof(costLine);
+                    newCost = std::stof(costLine);
                     if (newCost < 0.0f) { std::cout << "Please enter a non-negative number" << std::endl; continue; }
-                    book->setCost(newCost);
                 } catch (...) {
                     std::cout << "Please enter a non-negative number" << std::endl;
                     continue;
@@ -274,76 +493,89 @@ void BooksCollection::EditBook() {
         }
         default:
             std::cout << "Invalid choice. Returning to main menu.\n";
+            return;
     }
 
-    std::cout << "Book updated successfully.\n";
-}
-
-
-void BooksCollection::DeleteBook() {
-    Books* book = PromptForSearchMechanism();
+    // Look the book up again under its lock: it may have changed or gone meanwhile
+    std::lock_guard<std::mutex> record(RecordLock(libraryID));
+    Books* book = FindBookByID(libraryID);
     if (!book) {
         std::cout << "Book not found.\n";
         return;
     }
+    Books updated(*book);
+    if (choice == 1) updated.setTitle(newText);
+    else if (choice == 2) updated.setAuthor(newText);
+    else if (choice == 3) updated.setISBN(newText);
+    else updated.setCost(newCost);
+    {
+        std::unique_lock<std::shared_mutex> lock(booksMutex);
+        book = PublishVersion(book, std::move(updated));
+    }
 
-    auto it = std::find_if(booksList.begin(), booksList.end(), [book](const Books* b) { return b == book; });
-    if (it != booksList.end()) {
-        delete *it;
-        booksList.erase(it);
-        std::cout << "Book deleted successfully.\n";
-    } else {
-        std::cout << "Error deleting the book.\n";
+    if (journal) {
+        journal->LogBook(*book);
+        journal->Commit();
     }
+    std::cout << "Book updated successfully.\n";
 }
 
-Books* BooksCollection::PromptForSearchMechanism() {
+int BooksCollection::PromptForSearchMechanism() {
     std::string line;
     int choice = 0;
 
     // Read choice as a full line and parse it
     while (true) {
-        std::cout << "Search by (1) Title, (2) ISBN, or (3) ID? ";
-        if (!std::getline(std::cin, line)) return nullptr;
+        std::cout << "Search by (1) Title, (2) ISBN, (3) ID, or (4) Title/author words? ";
+        if (!std::getline(std::cin, line)) return 0;
         line = trim(line);
         if (line.empty()) continue;
         try {
             choice = std::stoi(line);
         } catch (...) {
-            std::cout << "Invalid input. Please enter 1, 2 or 3.\n";
+            std::cout << "Invalid input. Please enter 1, 2, 3 or 4.\n";
             continue;
         }
-        if (choice >= 1 && choice <= 3) break;
-        std::cout << "Please enter 1, 2 or 3.\n";
+        if (choice >= 1 && choice <= 4) break;
+        std::cout << "Please enter 1, 2, 3 or 4.\n";
     }
 
     if (choice == 1) {
         std::string title;
         std::cout << "Enter title: ";
-        if (!std::getline(std::cin, title)) return nullptr;
+        if (!std::getline(std::cin, title)) return 0;
         title = trim(title);
-        return FindBookByTitle(title);
+        {
+            Epoch::ReadGuard guard;
+            if (const Books* book = FindBookByTitle(title)) return book->getLibraryID();
+        }
+        return PromptForClosest(title);
     } else if (choice == 2) {
         std::string isbnInput;
         while (true) {
             std::cout << "Enter ISBN (10 digits): ";
-            if (!std::getline(std::cin, isbnInput)) return nullptr;
+            if (!std::getline(std::cin, isbnInput)) return 0;
             isbnInput = trim(isbnInput);
             if (isbnInput.empty()) continue;
-            bool ok = (isbnInput.size() == 10);
-            for (char c : isbnInput) if (!std::isdigit(static_cast<unsigned char>(c))) { ok = false; break; }
-            if (!ok) {
+            if (!IsValidISBN(isbnInput)) {
                 std::cout << "Please write 10 numbers" << std::endl;
                 continue;
             }
             break;
         }
-        return FindBookByISBN(isbnInput);
+        Epoch::ReadGuard guard;
+        const Books* book = FindBookByISBN(isbnInput);
+        return book ? book->getLibraryID() : 0;
+    } else if (choice == 4) {
+        std::string words;
+        std::cout << "Enter part of the title or author: ";
+        if (!std::getline(std::cin, words)) return 0;
+        return PromptForSearchResult(words);
     } else { // choice == 3
         int id = 0;
         while (true) {
             std::cout << "Enter ID: ";
-            if (!std::getline(std::cin, line)) return nullptr;
+            if (!std::getline(std::cin, line)) return 0;
             line = trim(line);
             if (line.empty()) continue;
             // Require exactly 8 digits for ID
@@ -359,47 +591,168 @@ Books* BooksCollection::PromptForSearchMechanism() {
                 std::cout << "Invalid ID. Enter a positive integer." << std::endl;
             }
         }
-        return FindBookByID(id);
+        return HasBookID(id) ? id : 0;
     }
 }
 
-Books* BooksCollection::FindBookByTitle(const std::string& title) {
-    const std::string key = toLower(trim(title));
-    for (auto* book : booksList) {
-        if (toLower(trim(book->getTitle())) == key) return book;
+// Word-prefix matches first (what a partial title usually is), then matches anywhere in
+// a word, then close spellings
+int BooksCollection::PromptForSearchResult(const std::string& words) {
+    const std::size_t maxListed = 10;
+    std::vector<int> ids = SearchBooks(words, CatalogSearchIndex::PREFIX, maxListed);
+    if (ids.empty()) ids = SearchBooks(words, CatalogSearchIndex::SUBSTRING, maxListed);
+    if (!ids.empty()) return PromptForPick(ids);
+    return PromptForClosest(words);
+}
+
+int BooksCollection::PromptForClosest(const std::string& words) {
+    std::vector<int> ids;
+    for (const CatalogSearchIndex::FuzzyMatch& match : FuzzySearchBooks(words)) ids.push_back(match.libraryID);
+    if (ids.empty()) return 0;
+    std::cout << "No exact match. Closest titles and authors:\n";
+    return PromptForPick(ids);
+}
+
+int BooksCollection::PromptForPick(const std::vector<int>& ids) {
+    std::vector<int> listed;
+    {
+        Epoch::ReadGuard guard;
+        for (int id : ids) {
+            const Books* book = LookupID(id);
+            if (!book) continue; // deleted since the search
+            listed.push_back(id);
+            std::cout << listed.size() << ". \"" << book->getTitle() << "\" by " << book->getAuthor()
+                      << " (ID " << id << ")\n";
+        }
+    }
+    if (listed.empty()) return 0;
+
+    std::string line;
+    while (true) {
+        std::cout << "Select a book (1-" << listed.size() << ", 0 for none): ";
+        if (!std::getline(std::cin, line)) return 0;
+        try {
+            std::size_t pick = static_cast<std::size_t>(std::stoul(trim(line)));
+            if (pick == 0) return 0;
+            if (pick <= listed.size()) return listed[pick - 1];
+        } catch (...) {}
+        std::cout << "Please enter a number from the list.\n";
     }
-    return nullptr;
+}
+
+// Lookups go through the hash indexes without locking; when several books share a title
+// or ISBN the one added first is returned, as the old linear scan did.
+Books* BooksCollection::FindBookByTitle(const std::string& title) {
+    Epoch::ReadGuard guard;
+    const std::vector<Books*>* books = booksByTitle.Find(titleKey(title));
+    return books ? books->front() : nullptr;
 }
 
 Books* BooksCollection::FindBookByISBN(const std::string& isbn) {
-    for (auto* book : booksList) {
-        if (book->getISBN() == isbn) return book;
+    if (!IsValidISBN(isbn)) return nullptr;
+    Epoch::ReadGuard guard;
+    const std::vector<Books*>* books = booksByISBN.Find(Books::PackISBN(isbn));
+    return books ? books->front() : nullptr;
+}
+
+Books* BooksCollection::FindAvailableByISBN(const std::string& isbn) {
+    if (!IsValidISBN(isbn)) return nullptr;
+    int id;
+    {
+        std::shared_lock<std::shared_mutex> lock(availabilityMutex);
+        id = availableByISBN.Any(Books::PackISBN(isbn));
     }
-    return nullptr;
+    return id ? FindBookByID(id) : nullptr;
 }
 
-Books* BooksCollection::FindBookByID(int id) {
-    for (auto* book : booksList) {
-        if (book->getLibraryID() == id) return book;
+Books* BooksCollection::FindAvailableByTitle(const std::string& title) {
+    const std::string key = titleKey(title);
+    int id;
+    {
+        std::shared_lock<std::shared_mutex> lock(availabilityMutex);
+        id = availableByTitle.Any(key);
+    }
+    return id ? FindBookByID(id) : nullptr;
+}
+
+Books* BooksCollection::FindAvailableCopy(const Books& book) {
+    if (book.getCurrentBookStatus() == Books::IN) return FindBookByID(book.getLibraryID());
+    const std::string key = titleKey(book.getTitle());
+    int id;
+    {
+        std::shared_lock<std::shared_mutex> lock(availabilityMutex);
+        id = availableByISBN.Any(book.getPackedISBN());
+        if (!id) id = availableByTitle.Any(key);
     }
-    return nullptr;
+    return id ? FindBookByID(id) : nullptr;
+}
+
+std::size_t BooksCollection::AvailableCopies(const Books& book) const {
+    std::shared_lock<std::shared_mutex> lock(availabilityMutex);
+    return availableByISBN.Count(book.getPackedISBN());
+}
+
+std::size_t BooksCollection::CopiesOf(std::uint64_t isbn) const {
+    Epoch::ReadGuard guard;
+    const std::vector<Books*>* books = booksByISBN.Find(isbn);
+    return books ? books->size() : 0;
+}
+
+void BooksCollection::SetBookStatus(Books& book, Books::BookStatus status) {
+    book.setCurrentBookStatus(status);
+    const std::string key = titleKey(book.getTitle());
+    const bool available = status == Books::IN;
+    std::unique_lock<std::shared_mutex> lock(availabilityMutex);
+    availableByISBN.Set(book.getLibraryID(), book.getPackedISBN(), available);
+    availableByTitle.Set(book.getLibraryID(), key, available);
+}
+
+Books* BooksCollection::FindBookByID(int id) {
+    Epoch::ReadGuard guard;
+    return LookupID(id);
+}
+
+Books* BooksCollection::LookupID(int id) const {
+    const BookRef* ref = booksByID.Find(id);
+    return ref ? ref->book : nullptr;
+}
+
+std::vector<int> BooksCollection::SearchBooks(std::string_view query, CatalogSearchIndex::MatchMode mode,
+                                              std::size_t maxResults) const {
+    std::shared_lock<std::shared_mutex> lock(searchMutex);
+    return searchIndex.Search(query, mode, maxResults);
+}
+
+std::vector<CatalogSearchIndex::FuzzyMatch> BooksCollection::FuzzySearchBooks(std::string_view query, std::size_t maxResults,
+                                                                             int maxEdits) const {
+    std::shared_lock<std::shared_mutex> lock(searchMutex);
+    return searchIndex.FuzzySearch(query, maxEdits, maxResults);
 }
 
 void BooksCollection::PrintAllBooks() const {
-    if (booksList.empty()) {
-        std::cout << "There are no books to print" << std::endl;
+    ReportWriter out;
+    PrintAllBooks(out);
+}
+
+void BooksCollection::PrintAllBooks(ReportWriter& out) const {
+    std::shared_lock<std::shared_mutex> lock(booksMutex);
+    if (booksByID.Size() == 0) {
+        out << "There are no books to print\n";
         return;
     }
 
-    for (const auto* book : booksList) {
-        std::cout << "ID: " << book->getLibraryID() << ", Title: " << book->getTitle() 
-                  << ", Author: " << book->getAuthor() << ", ISBN: " << book->getISBN() 
-                  << ", Cost: $" << book->getCost() << std::endl;
-    }
+    booksList.ForEach([this, &out](SlabHandle, const Books& book) {
+        if (!IsCurrent(book)) return;
+        out << "ID: " << book.getLibraryID() << ", Title: " << book.getTitle()
+            << ", Author: " << book.getAuthor() << ", ISBN: " << book.getISBN()
+            << ", Cost: $" << book.getCost() << '\n';
+    });
 }
 
 void BooksCollection::PrintBook() {
-    Books* book = PromptForSearchMechanism();
+    const int libraryID = PromptForSearchMechanism();
+    std::lock_guard<std::mutex> record(RecordLock(libraryID));
+    const Books* book = FindBookByID(libraryID);
     if (book) {
         std::cout << "ID: " << book->getLibraryID() << ", Title: " << book->getTitle() 
                   << ", Author: " << book->getAuthor() << ", ISBN: " << book->getISBN() 
@@ -1,9 +1,23 @@
 #ifndef BOOKSCOLLECTION_H
 #define BOOKSCOLLECTION_H
 
+#include <cstdint>
 #include <vector>
 #include <string> // Include the string header for std::string (Forgot to add on for the BooksCollection.cpp)
+#include <string_view>
+#include <mutex>
+#include <shared_mutex>
 #include "Books.h"
+#include "SlabStore.h"
+#include "ResultCode.h"
+#include "LockStripes.h"
+#include "Epoch.h"
+#include "RcuHashMap.h"
+#include "CatalogSearchIndex.h"
+#include "AvailabilityIndex.h"
+
+class Journal;
+class ReportWriter;
 
 class BooksCollection {
 public:
@@ -12,16 +26,164 @@ public:
 
     void AddBook();
     void EditBook();
-    void DeleteBook();
-    Books* PromptForSearchMechanism();
+    // Deleting a copy goes through LoansCollection::DeleteBook, which checks its loan and holds
+    // Library ID of the book the user searched for and picked, or 0. The book can change or
+    // go while the user types, so callers resolve the ID under a ReadGuard or record lock.
+    int PromptForSearchMechanism();
     Books* FindBookByTitle(const std::string& title);
     Books* FindBookByISBN(const std::string& isbn);
     Books* FindBookByID(int id);
-    void PrintAllBooks() const;
+
+    // A copy that is IN, found through the availability index in O(1); nullptr if every
+    // copy is out or lost. FindAvailableCopy returns book itself when it is IN, else another
+    // copy with its ISBN, else another copy with its title.
+    Books* FindAvailableByISBN(const std::string& isbn);
+    Books* FindAvailableByTitle(const std::string& title);
+    Books* FindAvailableCopy(const Books& book);
+    std::size_t AvailableCopies(const Books& book) const; // IN copies with its ISBN
+    std::size_t CopiesOf(std::uint64_t isbn) const;        // copies with a packed ISBN, in any status
+
+    // Changes a copy's status and keeps the availability index in step (caller holds the
+    // book's record lock)
+    void SetBookStatus(Books& book, Books::BookStatus status);
+    void PrintAllBooks() const;                 // to standard output
+    void PrintAllBooks(ReportWriter& out) const;
     void PrintBook();
 
+    // Core API (no console I/O). Applies the same validation rules as the interactive
+    // AddBook and logs to the journal.
+    ResultCode AddBook(const std::string& author, const std::string& title, const std::string& isbn,
+                       int libraryID, float cost, Books::BookStatus status = Books::IN,
+                       Books::Material material = Books::BOOK);
+
+    // Partial title/author search: books where every word of the query starts a word of
+    // the title or author (PREFIX) or occurs anywhere in them (SUBSTRING). Returns up to
+    // maxResults library IDs in ascending order.
+    std::vector<int> SearchBooks(std::string_view query,
+                                 CatalogSearchIndex::MatchMode mode = CatalogSearchIndex::PREFIX,
+                                 std::size_t maxResults = 20) const;
+
+    // Typo-tolerant search for when SearchBooks finds nothing: up to maxResults books whose
+    // title or author holds every query word within maxEdits edits (one for short words),
+    // closest first
+    std::vector<CatalogSearchIndex::FuzzyMatch> FuzzySearchBooks(std::string_view query, std::size_t maxResults = 10,
+                                                                 int maxEdits = 2) const;
+
+    // Validation rules shared by the prompts and the core API
+    static bool IsValidText(std::string_view s);     // letters and spaces, at least one letter (author, title)
+    static bool IsValidISBN(std::string_view isbn);  // exactly 10 digits
+    static bool IsValidLibraryID(int libraryID);     // positive and at most 8 digits
+    static bool IsValidCost(float cost);             // finite and non-negative
+    static bool IsValidCostText(std::string_view s); // digits with at most one dot, at least one digit
+
+    // Concurrency: the Find* lookups take no lock at all (see Epoch.h); adding, deleting and
+    // editing a book hold booksMutex exclusively, one writer at a time. An edit publishes a
+    // new copy of the record and retires the old one, so a looked-up Books* stays valid only
+    // inside an Epoch::ReadGuard or while holding RecordLock(libraryID), which keeps the book
+    // from being edited or deleted. A book's status changes in place under its record lock.
+    // Take record locks before booksMutex, never the other way round.
+    std::mutex& RecordLock(int libraryID) const { return recordLocks.For(libraryID); }
+
+    // Programmatic access (no console I/O), used by persistence.
+    // InsertBook returns false if the library ID is already taken. titleKey may carry
+    // a precomputed NormalizeTitle(title) to skip normalizing it again.
+    bool InsertBook(const std::string& author, const std::string& title, const std::string& isbn,
+                    int libraryID, float cost, Books::BookStatus status, Books::Material material,
+                    std::string_view titleKey = {});
+    void Reserve(std::size_t count);
+    std::size_t Count() const { return booksByID.Size(); }
+    bool HasBookID(int libraryID) const {
+        Epoch::ReadGuard guard;
+        return booksByID.Find(libraryID) != nullptr;
+    }
+
+    // Bulk load: stores books whose library IDs are new and distinct, then builds the ID,
+    // ISBN, title and search indexes concurrently, one thread each. titleKeys[i] must be
+    // NormalizeTitle of newBooks[i]'s title. Both vectors are moved from.
+    void InsertBooksBulk(std::vector<Books>& newBooks, std::vector<std::string>& titleKeys);
+
+    // Journal replay: store these exact fields (inserting or overwriting), or drop a book
+    void UpsertBook(const std::string& author, const std::string& title, const std::string& isbn,
+                    int libraryID, float cost, Books::BookStatus status, Books::Material material);
+    bool RemoveBook(int libraryID);
+
+    // Mutations made through the interactive functions are logged here (may be nullptr)
+    void SetJournal(Journal* journal);
+
+    template <typename Fn>
+    void ForEachBook(Fn fn) const {
+        std::shared_lock<std::shared_mutex> lock(booksMutex);
+        booksList.ForEach([&](SlabHandle, const Books& book) {
+            if (IsCurrent(book)) fn(book);
+        });
+    }
+
+    // Key used by the title index: trimmed and case-folded
+    static std::string NormalizeTitle(std::string_view title);
+
 private:
-    std::vector<Books*> booksList;
+    // Search prompts: list the SearchBooks / FuzzySearchBooks matches for words and let
+    // the user pick one (0 if none matched or none was picked)
+    int PromptForSearchResult(const std::string& words);
+    int PromptForClosest(const std::string& words);
+    int PromptForPick(const std::vector<int>& libraryIDs);
+
+    // A stored book: the pointer readers use and the slot that owns it
+    struct BookRef {
+        Books* book;
+        SlabHandle handle;
+    };
+    template <typename Key>
+    using BookBuckets = RcuHashMap<Key, std::vector<Books*>>;
+
+    // Keep the lookup indexes below in sync with booksList (caller holds booksMutex exclusively)
+    void IndexBook(SlabHandle handle, std::string_view titleKey = {});
+    void UnindexBook(SlabHandle handle);
+
+    // Stores updated as the new version of book and retires the old one (caller holds
+    // booksMutex exclusively and the book's record lock); returns the new version
+    Books* PublishVersion(Books* book, Books&& updated);
+
+    // Drops a book from the indexes; its slot is freed once no reader can see it
+    void RetireBook(SlabHandle handle);
+
+    // Handle of a stored book (books are unique by library ID)
+    SlabHandle HandleOf(const Books* book) const;
+
+    // False for versions that were replaced or deleted but not yet reclaimed
+    bool IsCurrent(const Books& book) const {
+        const BookRef* ref = booksByID.Find(book.getLibraryID());
+        return ref && ref->book == &book;
+    }
+
+    // Lookup for callers already holding booksMutex or a ReadGuard
+    Books* LookupID(int id) const;
+
+    SlabStore<Books> booksList;
+    Journal* journal = nullptr;
+
+    // Lookup indexes over booksList, readable without booksMutex
+    RcuHashMap<int, BookRef> booksByID; // library ID -> book
+    BookBuckets<std::uint64_t> booksByISBN; // packed ISBN -> books, in insertion order
+    BookBuckets<std::string> booksByTitle;           // normalized title -> books, in insertion order
+
+    // ISBN / normalized title -> copies that are IN. Guarded by availabilityMutex, which
+    // is taken last: under a record lock for status changes, after booksMutex when indexing.
+    AvailabilityIndex<std::uint64_t> availableByISBN;
+    AvailabilityIndex<std::string> availableByTitle;
+    mutable std::shared_mutex availabilityMutex;
+
+    // Title/author words -> books. Searches hold searchMutex shared; IndexBook and
+    // UnindexBook take it exclusively after booksMutex.
+    CatalogSearchIndex searchIndex;
+    mutable std::shared_mutex searchMutex;
+
+    // Replaced and deleted records waiting for readers to move on; declared after
+    // booksList so it is destroyed (and its pending slots erased) first
+    RetireList retiredBooks;
+
+    mutable std::shared_mutex booksMutex; // serializes writers to booksList and the indexes
+    mutable LockStripes recordLocks;      // per-book locks, by library ID
 };
 
 #endif // BOOKSCOLLECTION_H
@@ -0,0 +1,280 @@
+#include "CatalogExporter.h"
+#include "ReportWriter.h"
+#include "Epoch.h"
+#include <charconv>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+// helpers (file-local)
+namespace {
+
+enum ColumnType : std::uint8_t { INT32 = 1, INT64 = 2, FLOAT32 = 3, UINT8 = 4, STRING = 5 };
+
+struct Column {
+    const char* name;
+    ColumnType type;
+};
+
+// Receives one table row at a time, field by field in column order
+class RowSink {
+public:
+    explicit RowSink(ReportWriter& out) : out(out) {}
+    virtual ~RowSink() = default;
+
+    virtual void Int(std::int64_t value) = 0;
+    virtual void Real(float value) = 0;
+    virtual void Text(std::string_view value) = 0;
+    virtual void EndRow() = 0;
+    virtual void Finish() {}
+
+    std::size_t Rows() const { return rows; }
+
+protected:
+    ReportWriter& out;
+    std::size_t rows = 0;
+};
+
+// Shortest text that reads back as the same float
+void putReal(ReportWriter& out, float value) {
+    char text[32];
+    out << std::string_view(text, std::to_chars(text, text + sizeof(text), value).ptr - text);
+}
+
+class JsonLinesSink : public RowSink {
+public:
+    JsonLinesSink(ReportWriter& out, std::initializer_list<Column> columns) : RowSink(out), columns(columns) {}
+
+    void Int(std::int64_t value) override { Key() << value; }
+    void Real(float value) override { putReal(Key(), value); }
+
+    void Text(std::string_view value) override {
+        Key() << '"';
+        std::size_t plain = 0; // start of the run not yet written
+        for (std::size_t i = 0; i < value.size(); ++i) {
+            const unsigned char c = static_cast<unsigned char>(value[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') continue;
+            out << value.substr(plain, i - plain);
+            if (c == '"' || c == '\\') out << '\\' << static_cast<char>(c);
+            else {
+                static const char hex[] = "0123456789abcdef";
+                out << "\\u00" << hex[c >> 4] << hex[c & 15];
+            }
+            plain = i + 1;
+        }
+        out << value.substr(plain) << '"';
+    }
+
+    void EndRow() override {
+        out << "}\n";
+        field = 0;
+        ++rows;
+    }
+
+private:
+    ReportWriter& Key() {
+        out << (field == 0 ? "{\"" : ",\"") << columns[field].name << "\":";
+        ++field;
+        return out;
+    }
+
+    std::vector<Column> columns;
+    std::size_t field = 0;
+};
+
+class CsvSink : public RowSink {
+public:
+    CsvSink(ReportWriter& out, std::initializer_list<Column> columns) : RowSink(out) {
+        bool first = true;
+        for (const Column& column : columns) {
+            if (!first) out << ',';
+            out << column.name;
+            first = false;
+        }
+        out << '\n';
+    }
+
+    void Int(std::int64_t value) override { Separator() << value; }
+    void Real(float value) override { putReal(Separator(), value); }
+
+    void Text(std::string_view value) override {
+        Separator();
+        if (value.find_first_of(",\"\r\n") == std::string_view::npos) {
+            out << value;
+            return;
+        }
+        out << '"';
+        for (std::size_t quote; (quote = value.find('"')) != std::string_view::npos; value.remove_prefix(quote + 1)) {
+            out << value.substr(0, quote + 1) << '"';
+        }
+        out << value << '"';
+    }
+
+    void EndRow() override {
+        out << '\n';
+        first = true;
+        ++rows;
+    }
+
+private:
+    ReportWriter& Separator() {
+        if (!first) out << ',';
+        first = false;
+        return out;
+    }
+
+    bool first = true;
+};
+
+// Buffers one row group column by column, so memory is bounded by the group size
+class ColumnarSink : public RowSink {
+public:
+    static const std::uint32_t GROUP_ROWS = 65536;
+
+    ColumnarSink(ReportWriter& out, std::initializer_list<Column> columns) : RowSink(out), columns(columns) {
+        out.Write("LIBCOL1", 8);
+        Put(out, static_cast<std::uint32_t>(columns.size()));
+        for (const Column& column : columns) {
+            const std::string_view name(column.name);
+            Put(out, column.type);
+            Put(out, static_cast<std::uint8_t>(name.size()));
+            out << name;
+        }
+        values.resize(columns.size());
+        bytes.resize(columns.size());
+    }
+
+    void Int(std::int64_t value) override {
+        switch (columns[field].type) {
+            case INT32: Append(static_cast<std::int32_t>(value)); break;
+            case UINT8: Append(static_cast<std::uint8_t>(value)); break;
+            default: Append(value); break;
+        }
+    }
+
+    void Real(float value) override { Append(value); }
+
+    void Text(std::string_view value) override {
+        bytes[field] += value;
+        Append(static_cast<std::uint32_t>(bytes[field].size()));
+    }
+
+    void EndRow() override {
+        field = 0;
+        ++rows;
+        if (++groupRows == GROUP_ROWS) WriteGroup();
+    }
+
+    void Finish() override {
+        WriteGroup();
+        Put(out, std::uint32_t(0));
+    }
+
+private:
+    template <typename T>
+    static void Put(ReportWriter& out, T value) {
+        out.Write(&value, sizeof(T));
+    }
+
+    template <typename T>
+    void Append(T value) {
+        values[field].append(reinterpret_cast<const char*>(&value), sizeof(T));
+        ++field;
+    }
+
+    void WriteGroup() {
+        if (groupRows == 0) return;
+        Put(out, groupRows);
+        for (std::size_t c = 0; c < columns.size(); ++c) {
+            out << values[c];
+            values[c].clear();
+            if (columns[c].type == STRING) {
+                Put(out, static_cast<std::uint32_t>(bytes[c].size()));
+                out << bytes[c];
+                bytes[c].clear();
+            }
+        }
+        groupRows = 0;
+    }
+
+    std::vector<Column> columns;
+    std::vector<std::string> values; // fixed-width values, or string end offsets
+    std::vector<std::string> bytes;  // string contents
+    std::size_t field = 0;
+    std::uint32_t groupRows = 0;
+};
+
+std::unique_ptr<RowSink> makeSink(CatalogExporter::Format format, ReportWriter& out, std::initializer_list<Column> columns) {
+    switch (format) {
+        case CatalogExporter::JSONL: return std::make_unique<JsonLinesSink>(out, columns);
+        case CatalogExporter::CSV: return std::make_unique<CsvSink>(out, columns);
+        default: return std::make_unique<ColumnarSink>(out, columns);
+    }
+}
+
+bool endsWith(std::string_view s, std::string_view suffix) {
+    return s.size() >= suffix.size() && s.substr(s.size() - suffix.size()) == suffix;
+}
+
+} // namespace
+
+bool CatalogExporter::FormatForPath(std::string_view path, Format& format) {
+    if (endsWith(path, ".jsonl") || endsWith(path, ".json")) format = JSONL;
+    else if (endsWith(path, ".csv")) format = CSV;
+    else if (endsWith(path, ".bin")) format = COLUMNAR;
+    else return false;
+    return true;
+}
+
+std::size_t CatalogExporter::ExportBooks(const BooksCollection& books, Format format, ReportWriter& out) {
+    auto sink = makeSink(format, out, { { "author", STRING }, { "title", STRING }, { "isbn", STRING },
+                                        { "libraryID", INT32 }, { "cost", FLOAT32 }, { "status", UINT8 },
+                                        { "material", UINT8 } });
+    books.ForEachBook([&](const Books& book) {
+        sink->Text(book.getAuthor());
+        sink->Text(book.getTitle());
+        sink->Text(book.getISBN());
+        sink->Int(book.getLibraryID());
+        sink->Real(book.getCost());
+        sink->Int(book.getCurrentBookStatus());
+        sink->Int(book.getMaterial());
+        sink->EndRow();
+    });
+    sink->Finish();
+    return sink->Rows();
+}
+
+std::size_t CatalogExporter::ExportPatrons(const PatronsCollection& patrons, Format format, ReportWriter& out) {
+    auto sink = makeSink(format, out, { { "patronID", INT32 }, { "name", STRING }, { "fineBalance", FLOAT32 },
+                                        { "numBooks", INT32 } });
+    patrons.ForEachPatron([&](const Patron& patron) {
+        sink->Int(patron.getPatronID());
+        sink->Text(patron.getName());
+        sink->Real(patron.getFineBalance());
+        sink->Int(patron.getNumBooks());
+        sink->EndRow();
+    });
+    sink->Finish();
+    return sink->Rows();
+}
+
+std::size_t CatalogExporter::ExportLoans(const LoansCollection& loans, BooksCollection& books, Format format,
+                                         ReportWriter& out) {
+    auto sink = makeSink(format, out, { { "loanID", INT32 }, { "bookID", INT32 }, { "patronID", INT32 },
+                                        { "title", STRING }, { "dueEpoch", INT64 }, { "status", UINT8 } });
+    Epoch::ReadGuard guard; // keeps the joined books alive while their titles are written
+    loans.ForEachLoan([&](const Loans& loan) {
+        const Books* book = books.FindBookByID(loan.getBookID());
+        sink->Int(loan.getLoanID());
+        sink->Int(loan.getBookID());
+        sink->Int(loan.getPatronID());
+        sink->Text(book ? book->getTitle() : std::string_view());
+        sink->Int(loan.getDueEpoch());
+        sink->Int(loan.getStatus());
+        sink->EndRow();
+    });
+    sink->Finish();
+    return sink->Rows();
+}
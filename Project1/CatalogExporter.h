@@ -0,0 +1,44 @@
+#ifndef CATALOGEXPORTER_H
+#define CATALOGEXPORTER_H
+
+#include <cstddef>
+#include <string_view>
+#include "PatronsCollection.h"
+#include "BooksCollection.h"
+#include "LoansCollection.h"
+
+class ReportWriter;
+
+// Machine-readable exports of the books, patrons and loans tables, for analytics jobs.
+//
+// Rows are streamed straight from the collections into a ReportWriter, so memory use does
+// not grow with the table. Columns (statuses are the numeric enum values):
+//   books:   author, title, isbn, libraryID, cost, status, material
+//            (status 0 IN, 1 OUT, 2 LOST, 3 ON_HOLD; material 0 book, 1 DVD, 2 magazine, 3 audiobook)
+//   patrons: patronID, name, fineBalance, numBooks
+//   loans:   loanID, bookID, patronID, title, dueEpoch, status   (0 NORMAL, 1 OVERDUE, 2 RETURNED)
+// The loans export joins each loan to its book's title through the ID index.
+//
+// Formats:
+//   JSONL     one object per line, keys as above
+//   CSV       header row, RFC 4180 quoting; the books file can be fed back to CatalogImporter
+//   COLUMNAR  binary, native little-endian:
+//               "LIBCOL1\0", u32 column count, per column: u8 type, u8 name length, name
+//               then row groups of up to 65536 rows: u32 row count, then each column's
+//               values in column order; a row count of 0 ends the file.
+//             Column types: 1 int32, 2 int64, 3 float32, 4 uint8 (one value per row),
+//             5 string (u32 end offset per row, u32 byte count, then the bytes).
+class CatalogExporter {
+public:
+    enum Format { JSONL, CSV, COLUMNAR };
+
+    // Format named by a file extension (.jsonl/.json, .csv, .bin); false if unknown
+    static bool FormatForPath(std::string_view path, Format& format);
+
+    // Each returns the number of rows written
+    static std::size_t ExportBooks(const BooksCollection& books, Format format, ReportWriter& out);
+    static std::size_t ExportPatrons(const PatronsCollection& patrons, Format format, ReportWriter& out);
+    static std::size_t ExportLoans(const LoansCollection& loans, BooksCollection& books, Format format, ReportWriter& out);
+};
+
+#endif // CATALOGEXPORTER_H
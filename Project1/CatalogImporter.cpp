@@ -0,0 +1,399 @@
+#include "CatalogImporter.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+
+// helpers (file-local)
+namespace {
+
+// Splits a mapped CSV/TSV buffer into rows of string_view fields. Fields point into the
+// mapping; only quoted fields containing "" escapes are copied (into a per-row scratch buffer).
+class RowReader {
+public:
+    RowReader(const char* begin, const char* end, char delimiter, std::size_t firstLine)
+        : pos(begin), end(end), delimiter(delimiter), line(firstLine), nextLine(firstLine) {}
+
+    // Reads the next non-blank row; returns false at the end of the input
+    bool Next(std::vector<std::string_view>& fields) {
+        while (pos < end) {
+            line = nextLine;
+            spans.clear();
+            scratch.clear();
+            ReadRow();
+            if (spans.size() == 1 && spans[0].size == 0) continue; // blank line
+
+            fields.clear();
+            for (const Span& span : spans) {
+                fields.emplace_back(span.inScratch ? scratch.data() + span.offset : span.data, span.size);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Line number where the last row returned by Next starts
+    std::size_t Line() const { return line; }
+
+    // Line number following the last row read
+    std::size_t NextLine() const { return nextLine; }
+
+private:
+    struct Span {
+        const char* data;
+        std::size_t offset; // into scratch when inScratch
+        std::size_t size;
+        bool inScratch;
+    };
+
+    void ReadRow() {
+        while (true) {
+            if (delimiter == ',' && pos < end && *pos == '"') ReadQuoted();
+            else ReadPlain();
+
+            if (pos < end && *pos == delimiter) { ++pos; continue; }
+            if (pos < end) { ++pos; ++nextLine; } // newline
+            return;
+        }
+    }
+
+    void ReadPlain() {
+        const char* start = pos;
+        while (pos < end && *pos != delimiter && *pos != '\n') ++pos;
+        const char* stop = pos;
+        while (start < stop && (*start == ' ' || *start == '\t')) ++start;
+        while (stop > start && (stop[-1] == ' ' || stop[-1] == '\t' || stop[-1] == '\r')) --stop;
+        spans.push_back({ start, 0, static_cast<std::size_t>(stop - start), false });
+    }
+
+    void ReadQuoted() {
+        const char* start = ++pos;
+        bool escaped = false;
+        while (pos < end) {
+            if (*pos == '"') {
+                if (pos + 1 < end && pos[1] == '"') { escaped = true; pos += 2; continue; }
+                break;
+            }
+            if (*pos == '\n') ++nextLine;
+            ++pos;
+        }
+        const char* stop = pos;
+        if (!escaped) {
+            spans.push_back({ start, 0, static_cast<std::size_t>(stop - start), false });
+        } else {
+            std::size_t offset = scratch.size();
+            for (const char* p = start; p < stop; ++p) {
+                scratch.push_back(*p);
+                if (*p == '"') ++p; // keep one quote of each ""
+            }
+            spans.push_back({ nullptr, offset, scratch.size() - offset, true });
+        }
+        // skip the closing quote and anything up to the next field
+        while (pos < end && *pos != delimiter && *pos != '\n') ++pos;
+    }
+
+    const char* pos;
+    const char* end;
+    char delimiter;
+    std::size_t line;
+    std::size_t nextLine;
+    std::vector<Span> spans;
+    std::string scratch;
+};
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+    }
+    return true;
+}
+
+bool parseInt(std::string_view s, int& value) {
+    auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+    return result.ec == std::errc() && result.ptr == s.data() + s.size();
+}
+
+bool parseFloat(std::string_view s, float& value) {
+    auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+    return result.ec == std::errc() && result.ptr == s.data() + s.size();
+}
+
+// Same rules as the AddBook prompt: a plain decimal, finite once parsed
+bool parseCost(std::string_view s, float& cost) {
+    return BooksCollection::IsValidCostText(s) && parseFloat(s, cost) && BooksCollection::IsValidCost(cost);
+}
+
+char detectDelimiter(const char* data, std::size_t size) {
+    const char* firstNewline = std::find(data, data + size, '\n');
+    return std::find(data, firstNewline, '\t') != firstNewline ? '\t' : ',';
+}
+
+struct Chunk {
+    const char* begin;
+    const char* end;
+};
+
+// Cuts the file into pieces of about targetSize bytes, each ending after a newline.
+// CSV files containing quotes are cut only outside quoted fields, which needs one
+// sequential pass over the quote characters; other files are cut directly.
+std::vector<Chunk> splitChunks(const char* data, std::size_t size, char delimiter, std::size_t targetSize) {
+    std::vector<Chunk> chunks;
+    const char* end = data + size;
+    const bool quoted = delimiter == ',' && std::find(data, end, '"') != end;
+    const char* begin = data;
+    bool inQuotes = false;
+    const char* scan = data;
+    while (begin < end) {
+        const char* cut = begin + std::min(targetSize, static_cast<std::size_t>(end - begin));
+        if (!quoted) {
+            cut = std::find(cut, end, '\n');
+        } else {
+            for (; scan < end; ++scan) {
+                if (*scan == '"') inQuotes = !inQuotes;
+                else if (*scan == '\n' && !inQuotes && scan >= cut) break;
+            }
+            cut = scan;
+        }
+        if (cut < end) ++cut; // keep the newline with its row
+        chunks.push_back({ begin, cut });
+        begin = cut;
+        scan = cut;
+    }
+    return chunks;
+}
+
+unsigned workerCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Runs fn(0) .. fn(count - 1) on a pool of worker threads (including the caller)
+template <typename Fn>
+void parallelFor(std::size_t count, Fn fn) {
+    const std::size_t threads = std::min<std::size_t>(count, workerCount());
+    std::atomic<std::size_t> next{ 0 };
+    auto work = [&] {
+        for (std::size_t i = next++; i < count; i = next++) fn(i);
+    };
+    std::vector<std::thread> pool;
+    for (std::size_t t = 1; t < threads; ++t) pool.emplace_back(work);
+    work();
+    for (std::thread& thread : pool) thread.join();
+}
+
+std::vector<Chunk> chunksFor(const MappedFile& file, char delimiter) {
+    const std::size_t minChunk = 1 << 20;
+    std::size_t target = std::max<std::size_t>(minChunk, file.Size() / (workerCount() * 4));
+    return splitChunks(file.Data(), file.Size(), delimiter, target);
+}
+
+// Line number of each chunk's first row, given the newline count of every chunk
+void assignFirstLines(std::vector<std::size_t>& lines) {
+    std::size_t line = 1;
+    for (std::size_t& count : lines) {
+        std::size_t chunkLines = count;
+        count = line;
+        line += chunkLines;
+    }
+}
+
+// Parse stage output for one chunk. Line numbers are relative to the chunk until merged.
+struct BookChunk {
+    std::vector<Books> books;
+    std::vector<std::string> titleKeys;
+    std::vector<std::size_t> lines;   // line of each entry in books
+    std::vector<char> duplicate;      // set by the dedup stage
+    std::vector<CatalogImporter::RejectedRow> rejected;
+    std::size_t rows = 0;
+};
+
+struct PatronChunk {
+    std::vector<std::string> names;
+    std::vector<CatalogImporter::RejectedRow> rejected;
+    std::size_t rows = 0;
+};
+
+std::size_t countNewlines(const Chunk& chunk) {
+    return static_cast<std::size_t>(std::count(chunk.begin, chunk.end, '\n'));
+}
+
+void sortRejected(std::vector<CatalogImporter::RejectedRow>& rejected) {
+    std::sort(rejected.begin(), rejected.end(),
+              [](const CatalogImporter::RejectedRow& a, const CatalogImporter::RejectedRow& b) { return a.line < b.line; });
+}
+
+} // namespace
+
+// Pipeline: split into chunks -> parse and validate chunks in parallel -> drop duplicate
+// library IDs (sharded by ID, in parallel) -> store in file order and build the indexes.
+bool CatalogImporter::ImportBooks(const std::string& path, BooksCollection& books, Report& report) {
+    MappedFile file;
+    if (!file.Open(path)) return false;
+    if (file.Size() == 0) return true;
+
+    const char delimiter = detectDelimiter(file.Data(), file.Size());
+    std::vector<Chunk> chunks = chunksFor(file, delimiter);
+    std::vector<BookChunk> parsed(chunks.size());
+    std::vector<std::size_t> firstLines(chunks.size());
+
+    parallelFor(chunks.size(), [&](std::size_t c) {
+        BookChunk& out = parsed[c];
+        RowReader reader(chunks[c].begin, chunks[c].end, delimiter, 0);
+        std::vector<std::string_view> f;
+        bool headerAllowed = c == 0;
+        while (reader.Next(f)) {
+            if (headerAllowed) {
+                headerAllowed = false;
+                if (equalsIgnoreCase(f[0], "author")) continue;
+            }
+            ++out.rows;
+
+            const char* reason = nullptr;
+            int libraryID = 0;
+            int status = Books::IN;
+            int material = Books::BOOK;
+            float cost = 0.0f;
+            if (f.size() < 5 || f.size() > 7) reason = "wrong number of fields";
+            else if (!BooksCollection::IsValidText(f[0])) reason = "invalid author";
+            else if (!BooksCollection::IsValidText(f[1])) reason = "invalid title";
+            else if (!BooksCollection::IsValidISBN(f[2])) reason = "invalid ISBN";
+            else if (!parseInt(f[3], libraryID) || !BooksCollection::IsValidLibraryID(libraryID)) reason = "invalid library ID";
+            else if (!parseCost(f[4], cost)) reason = "invalid cost";
+            else if (f.size() >= 6 && (!parseInt(f[5], status) || status < Books::IN || status > Books::ON_HOLD)) reason = "invalid status";
+            else if (f.size() == 7 && (!parseInt(f[6], material) || material < 0 || material >= Books::MATERIAL_COUNT)) reason = "invalid material";
+
+            if (reason) {
+                out.rejected.push_back({ reader.Line(), reason });
+                continue;
+            }
+            if (status == Books::ON_HOLD) status = Books::IN; // holds are not imported, so the copy is back on the shelf
+            out.books.emplace_back(std::string(f[0]), std::string(f[1]), std::string(f[2]), libraryID, cost,
+                                   static_cast<Books::BookStatus>(status), static_cast<Books::Material>(material));
+            out.titleKeys.push_back(BooksCollection::NormalizeTitle(f[1]));
+            out.lines.push_back(reader.Line());
+        }
+        out.duplicate.assign(out.books.size(), 0);
+        firstLines[c] = countNewlines(chunks[c]);
+    });
+    assignFirstLines(firstLines);
+
+    // The first occurrence of a library ID wins; IDs already in the collection lose.
+    // Each shard owns the IDs that hash to it, so shards never touch the same entry.
+    const std::size_t shards = std::min<std::size_t>(workerCount(), 64);
+    parallelFor(shards, [&](std::size_t shard) {
+        std::unordered_set<int> seen;
+        for (BookChunk& chunk : parsed) {
+            for (std::size_t i = 0; i < chunk.books.size(); ++i) {
+                int id = chunk.books[i].getLibraryID();
+                if (static_cast<std::size_t>(id) % shards != shard) continue;
+                if (books.HasBookID(id) || !seen.insert(id).second) chunk.duplicate[i] = 1;
+            }
+        }
+    });
+
+    std::size_t accepted = 0;
+    for (const BookChunk& chunk : parsed) accepted += chunk.books.size();
+    std::vector<Books> newBooks;
+    std::vector<std::string> titleKeys;
+    newBooks.reserve(accepted);
+    titleKeys.reserve(accepted);
+    for (std::size_t c = 0; c < parsed.size(); ++c) {
+        BookChunk& chunk = parsed[c];
+        report.rows += chunk.rows;
+        for (RejectedRow& row : chunk.rejected) report.rejected.push_back({ firstLines[c] + row.line, row.reason });
+        for (std::size_t i = 0; i < chunk.books.size(); ++i) {
+            if (chunk.duplicate[i]) {
+                report.rejected.push_back({ firstLines[c] + chunk.lines[i], "duplicate library ID" });
+                continue;
+            }
+            newBooks.push_back(std::move(chunk.books[i]));
+            titleKeys.push_back(std::move(chunk.titleKeys[i]));
+        }
+        chunk = BookChunk(); // release the chunk's memory as we go
+    }
+    report.imported = newBooks.size();
+    sortRejected(report.rejected);
+
+    books.InsertBooksBulk(newBooks, titleKeys);
+    return true;
+}
+
+// Pipeline: split into chunks -> parse and validate chunks in parallel -> assign IDs
+// and store in file order.
+bool CatalogImporter::ImportPatrons(const std::string& path, PatronsCollection& patrons, Report& report) {
+    MappedFile file;
+    if (!file.Open(path)) return false;
+    if (file.Size() == 0) return true;
+
+    const char delimiter = detectDelimiter(file.Data(), file.Size());
+    std::vector<Chunk> chunks = chunksFor(file, delimiter);
+    std::vector<PatronChunk> parsed(chunks.size());
+    std::vector<std::size_t> firstLines(chunks.size());
+
+    parallelFor(chunks.size(), [&](std::size_t c) {
+        PatronChunk& out = parsed[c];
+        RowReader reader(chunks[c].begin, chunks[c].end, delimiter, 0);
+        std::vector<std::string_view> f;
+        bool headerAllowed = c == 0;
+        while (reader.Next(f)) {
+            if (headerAllowed) {
+                headerAllowed = false;
+                if (equalsIgnoreCase(f[0], "firstname") || equalsIgnoreCase(f[0], "first")) continue;
+            }
+            ++out.rows;
+
+            const char* reason = nullptr;
+            if (f.size() != 2) reason = "wrong number of fields";
+            else if (!PatronsCollection::IsValidNamePart(f[0])) reason = "invalid first name";
+            else if (!PatronsCollection::IsValidNamePart(f[1])) reason = "invalid last name";
+
+            if (reason) {
+                out.rejected.push_back({ reader.Line(), reason });
+                continue;
+            }
+            std::string name;
+            name.reserve(f[0].size() + 1 + f[1].size());
+            name.append(f[0]);
+            name += ' ';
+            name.append(f[1]);
+            out.names.push_back(std::move(name));
+        }
+        firstLines[c] = countNewlines(chunks[c]);
+    });
+    assignFirstLines(firstLines);
+
+    std::size_t accepted = 0;
+    for (const PatronChunk& chunk : parsed) accepted += chunk.names.size();
+    std::vector<Patron> imported;
+    imported.reserve(accepted);
+    int id = PatronsCollection::GetNextPatronID();
+    for (std::size_t c = 0; c < parsed.size(); ++c) {
+        PatronChunk& chunk = parsed[c];
+        report.rows += chunk.rows;
+        for (RejectedRow& row : chunk.rejected) report.rejected.push_back({ firstLines[c] + row.line, row.reason });
+        for (std::string& name : chunk.names) imported.emplace_back(std::move(name), id++);
+        chunk = PatronChunk();
+    }
+    patrons.InsertPatronsBulk(imported);
+    PatronsCollection::SetNextPatronID(id);
+    report.imported = accepted;
+    sortRejected(report.rejected);
+    return true;
+}
+
+void CatalogImporter::PrintReport(const Report& report, std::size_t maxListed) {
+    std::cout << "Read " << report.rows << " row(s): " << report.imported << " imported, "
+              << report.rejected.size() << " rejected.\n";
+    std::size_t listed = std::min(maxListed, report.rejected.size());
+    for (std::size_t i = 0; i < listed; ++i) {
+        std::cout << "  line " << report.rejected[i].line << ": " << report.rejected[i].reason << "\n";
+    }
+    if (listed < report.rejected.size()) {
+        std::cout << "  ... and " << (report.rejected.size() - listed) << " more\n";
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef CATALOGIMPORTER_H
+#define CATALOGIMPORTER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "PatronsCollection.h"
+#include "BooksCollection.h"
+
+// Bulk loader for book and patron exports in CSV or TSV.
+//
+// The delimiter is a tab if the first line contains one, otherwise a comma. CSV fields
+// may be double-quoted ("" inside quotes is a literal quote). An optional header row is
+// recognized by its first column name. Columns:
+//   books:   author, title, isbn, libraryID, cost [, status 0 = IN / 1 = OUT / 2 = LOST / 3 = ON_HOLD
+//            [, material 0 = book / 1 = DVD / 2 = magazine / 3 = audiobook]]
+//   patrons: firstName, lastName            (IDs are assigned in file order)
+// Rows are validated with the same rules as the interactive AddBook/AddPatron; rejected
+// rows are skipped and listed in the report. Holds are not part of the file, so a copy
+// exported as ON_HOLD comes in as IN. Imports bypass the journal, so the caller should
+// checkpoint afterwards.
+//
+// The file is cut into chunks at row boundaries and the chunks are parsed and validated
+// on all cores; results are then merged in file order, so the outcome (IDs, which of
+// two duplicate library IDs wins) is the same as a sequential import.
+class CatalogImporter {
+public:
+    struct RejectedRow {
+        std::size_t line;
+        const char* reason;
+    };
+
+    struct Report {
+        std::size_t rows = 0;     // data rows read (header excluded)
+        std::size_t imported = 0;
+        std::vector<RejectedRow> rejected; // in line order
+    };
+
+    // Each returns false if the file cannot be read
+    static bool ImportBooks(const std::string& path, BooksCollection& books, Report& report);
+    static bool ImportPatrons(const std::string& path, PatronsCollection& patrons, Report& report);
+
+    // Prints the totals and the first maxListed rejected rows
+    static void PrintReport(const Report& report, std::size_t maxListed = 20);
+};
+
+#endif // CATALOGIMPORTER_H
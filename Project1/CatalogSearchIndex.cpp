@@ -0,0 +1,277 @@
+#include "CatalogSearchIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <queue>
+#include <set>
+
+// helpers (file-local)
+namespace {
+
+const std::uint32_t PAD = 0;
+
+// Gram symbol of a normalized character: space 1, digits 2-11, letters 12-37
+std::uint32_t symbolOf(char c) {
+    if (c == ' ') return 1;
+    if (c >= '0' && c <= '9') return 2 + static_cast<std::uint32_t>(c - '0');
+    return 12 + static_cast<std::uint32_t>(c - 'a');
+}
+
+std::uint32_t gramOf(std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+    return (a * CatalogSearchIndex::SYMBOLS + b) * CatalogSearchIndex::SYMBOLS + c;
+}
+
+// " word word ...": lower-case letters and digits, each word preceded by one space
+void appendNormalized(std::string_view text, std::string& out) {
+    bool inWord = false;
+    for (unsigned char ch : text) {
+        if (ch < 0x80 && std::isalnum(ch)) {
+            if (!inWord) out.push_back(' ');
+            out.push_back(static_cast<char>(std::tolower(ch)));
+            inWord = true;
+        } else {
+            inWord = false;
+        }
+    }
+}
+
+// Calls fn with each word of a normalized text
+template <typename Fn>
+void forEachWord(const std::string& text, Fn fn) {
+    std::size_t start = 0;
+    while (start < text.size()) {
+        std::size_t end = text.find(' ', start + 1);
+        if (end == std::string::npos) end = text.size();
+        fn(text.substr(start + 1, end - start - 1));
+        start = end;
+    }
+}
+
+// True if needle (" word") occurs in a normalized text followed by a word boundary
+bool containsWord(const std::string& text, const std::string& needle) {
+    for (std::size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) {
+        std::size_t end = pos + needle.size();
+        if (end == text.size() || text[end] == ' ') return true;
+    }
+    return false;
+}
+
+// Grams a document must contain to match one query word. A one-letter substring has
+// none, so it is checked against every book.
+void queryGrams(const std::string& word, CatalogSearchIndex::MatchMode mode, std::vector<std::uint32_t>& grams) {
+    const bool wordStart = mode != CatalogSearchIndex::SUBSTRING;
+    std::string padded = wordStart ? " " + word : word;
+    if (wordStart) grams.push_back(gramOf(1, symbolOf(word[0]), PAD));
+    if (padded.size() == 2) grams.push_back(gramOf(symbolOf(padded[0]), symbolOf(padded[1]), PAD));
+    for (std::size_t i = 0; i + 3 <= padded.size(); ++i) {
+        grams.push_back(gramOf(symbolOf(padded[i]), symbolOf(padded[i + 1]), symbolOf(padded[i + 2])));
+    }
+}
+
+// Moves pos forward to the first entry of an ascending list that is >= id and reports
+// whether it equals id. Gallops (doubling steps from pos, then a binary search inside
+// the bracket), so walking a list to k targets costs O(k * log(list size / k)).
+bool gallopTo(const std::vector<int>& list, std::size_t& pos, int id) {
+    std::size_t lo = pos;
+    std::size_t hi = pos;
+    std::size_t step = 1;
+    while (hi < list.size() && list[hi] < id) {
+        lo = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    hi = std::min(hi + 1, list.size());
+    pos = static_cast<std::size_t>(std::lower_bound(list.begin() + lo, list.begin() + hi, id) - list.begin());
+    return pos < list.size() && list[pos] == id;
+}
+
+} // namespace
+
+std::vector<std::string> CatalogSearchIndex::Words(std::string_view text) {
+    std::string normalized;
+    appendNormalized(text, normalized);
+    std::vector<std::string> words;
+    forEachWord(normalized, [&](std::string word) { words.push_back(std::move(word)); });
+    return words;
+}
+
+// Each word yields " a", its bigrams and its trigrams (" ab" included); grams never
+// span two words
+void CatalogSearchIndex::GramsOf(std::string_view text, std::vector<std::uint32_t>& grams) {
+    grams.clear();
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == ' ') grams.push_back(gramOf(1, symbolOf(text[i + 1]), PAD));
+        else if (i + 1 < text.size() && text[i + 1] != ' ') grams.push_back(gramOf(symbolOf(text[i]), symbolOf(text[i + 1]), PAD));
+        if (i + 2 < text.size() && text[i + 1] != ' ' && text[i + 2] != ' ') {
+            grams.push_back(gramOf(symbolOf(text[i]), symbolOf(text[i + 1]), symbolOf(text[i + 2])));
+        }
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+}
+
+void CatalogSearchIndex::AddGrams(int libraryID, const std::string& text) {
+    std::vector<std::uint32_t> grams;
+    GramsOf(text, grams);
+    for (std::uint32_t gram : grams) {
+        std::vector<int>& list = postings[gram];
+        if (list.empty() || list.back() < libraryID) list.push_back(libraryID);
+        else list.insert(std::lower_bound(list.begin(), list.end(), libraryID), libraryID);
+    }
+}
+
+void CatalogSearchIndex::Add(int libraryID, std::string_view title, std::string_view author) {
+    Remove(libraryID);
+    std::string text;
+    appendNormalized(title, text);
+    appendNormalized(author, text);
+    AddGrams(libraryID, text);
+    forEachWord(text, [this](const std::string& word) { vocabulary.Add(word); });
+    texts.emplace(libraryID, std::move(text));
+}
+
+void CatalogSearchIndex::Remove(int libraryID) {
+    auto it = texts.find(libraryID);
+    if (it == texts.end()) return;
+    std::vector<std::uint32_t> grams;
+    GramsOf(it->second, grams);
+    for (std::uint32_t gram : grams) {
+        std::vector<int>& list = postings[gram];
+        auto pos = std::lower_bound(list.begin(), list.end(), libraryID);
+        if (pos != list.end() && *pos == libraryID) list.erase(pos);
+    }
+    forEachWord(it->second, [this](const std::string& word) { vocabulary.Remove(word); });
+    texts.erase(it);
+}
+
+// Appending in ID order keeps most lists sorted as they grow; only lists that already
+// held larger IDs are sorted again at the end
+void CatalogSearchIndex::AddBulk(std::vector<Entry> entries) {
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.libraryID < b.libraryID; });
+    texts.reserve(texts.size() + entries.size());
+    std::vector<bool> unsorted(GRAMS, false);
+    std::vector<std::uint32_t> grams;
+    for (const Entry& entry : entries) {
+        std::string text;
+        appendNormalized(entry.title, text);
+        appendNormalized(entry.author, text);
+        GramsOf(text, grams);
+        for (std::uint32_t gram : grams) {
+            std::vector<int>& list = postings[gram];
+            if (!list.empty() && list.back() > entry.libraryID) unsorted[gram] = true;
+            list.push_back(entry.libraryID);
+        }
+        forEachWord(text, [this](const std::string& word) { vocabulary.Add(word); });
+        texts.emplace(entry.libraryID, std::move(text));
+    }
+    for (std::uint32_t gram = 0; gram < GRAMS; ++gram) {
+        if (unsorted[gram]) std::sort(postings[gram].begin(), postings[gram].end());
+    }
+}
+
+std::vector<int> CatalogSearchIndex::Search(std::string_view query, MatchMode mode, std::size_t maxResults) const {
+    std::vector<int> results;
+    std::vector<std::string> words = Words(query);
+    if (words.empty() || maxResults == 0) return results;
+
+    std::vector<std::uint32_t> grams;
+    for (const std::string& word : words) queryGrams(word, mode, grams);
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    // Candidates are books on every gram's list. The rarest list drives; the others are
+    // galloped through in step, so the walk stops as soon as enough matches are found.
+    std::vector<const std::vector<int>*> lists;
+    for (std::uint32_t gram : grams) {
+        if (postings[gram].empty()) return results;
+        lists.push_back(&postings[gram]);
+    }
+    std::sort(lists.begin(), lists.end(), [](const std::vector<int>* a, const std::vector<int>* b) { return a->size() < b->size(); });
+
+    std::vector<int> everyBook;
+    if (lists.empty()) {
+        // Only one-letter substrings: check every book
+        everyBook.reserve(texts.size());
+        for (const auto& entry : texts) everyBook.push_back(entry.first);
+        std::sort(everyBook.begin(), everyBook.end());
+        lists.push_back(&everyBook);
+    }
+
+    std::vector<std::string> needles;
+    for (const std::string& word : words) needles.push_back(mode == SUBSTRING ? word : " " + word);
+    std::vector<std::size_t> cursors(lists.size(), 0);
+    for (int id : *lists[0]) {
+        bool onEveryList = true;
+        for (std::size_t i = 1; i < lists.size() && onEveryList; ++i) {
+            if (!gallopTo(*lists[i], cursors[i], id)) {
+                if (cursors[i] == lists[i]->size()) return results; // no larger IDs left on that list
+                onEveryList = false;
+            }
+        }
+        if (!onEveryList) continue;
+
+        // Sharing every gram does not guarantee that each word occurs
+        const std::string& text = texts.at(id);
+        bool matches = true;
+        for (const std::string& needle : needles) {
+            bool found = mode == WORD ? containsWord(text, needle) : text.find(needle) != std::string::npos;
+            if (!found) { matches = false; break; }
+        }
+        if (matches) {
+            results.push_back(id);
+            if (results.size() == maxResults) break;
+        }
+    }
+    return results;
+}
+
+// Spellings are combined best-first: the queue yields choices of one spelling per query
+// word in order of total edits, and each choice runs as an exact WORD query
+std::vector<CatalogSearchIndex::FuzzyMatch> CatalogSearchIndex::FuzzySearch(std::string_view query, int maxEdits,
+                                                                            std::size_t maxResults) const {
+    const std::size_t SPELLINGS_PER_WORD = 8;
+    const std::size_t MAX_COMBINATIONS = 32;
+
+    std::vector<FuzzyMatch> results;
+    std::vector<std::string> words = Words(query);
+    if (words.empty() || maxResults == 0) return results;
+
+    std::vector<std::vector<BkTree::Match>> spellings;
+    for (const std::string& word : words) {
+        int allowed = std::min(maxEdits, word.size() <= 4 ? 1 : 2);
+        spellings.push_back(vocabulary.Find(word, std::max(allowed, 0), SPELLINGS_PER_WORD));
+        if (spellings.back().empty()) return results;
+    }
+
+    using Choice = std::pair<int, std::vector<std::size_t>>; // (total edits, spelling index per word)
+    auto totalOf = [&](const std::vector<std::size_t>& picks) {
+        int total = 0;
+        for (std::size_t i = 0; i < picks.size(); ++i) total += spellings[i][picks[i]].distance;
+        return total;
+    };
+    std::priority_queue<Choice, std::vector<Choice>, std::greater<Choice>> queue;
+    std::set<std::vector<std::size_t>> queued;
+    std::vector<std::size_t> first(words.size(), 0);
+    queue.emplace(totalOf(first), first);
+    queued.insert(first);
+
+    std::set<int> seen;
+    for (std::size_t tried = 0; tried < MAX_COMBINATIONS && !queue.empty(); ++tried) {
+        Choice choice = queue.top();
+        queue.pop();
+
+        std::string corrected;
+        for (std::size_t i = 0; i < words.size(); ++i) corrected += *spellings[i][choice.second[i]].word + " ";
+        for (int id : Search(corrected, WORD, maxResults)) {
+            if (!seen.insert(id).second) continue;
+            results.push_back(FuzzyMatch{ id, choice.first });
+            if (results.size() == maxResults) return results;
+        }
+
+        for (std::size_t i = 0; i < words.size(); ++i) {
+            std::vector<std::size_t> next = choice.second;
+            if (++next[i] >= spellings[i].size() || !queued.insert(next).second) continue;
+            queue.emplace(totalOf(next), next);
+        }
+    }
+    return results;
+}
@@ -0,0 +1,75 @@
+#ifndef CATALOGSEARCHINDEX_H
+#define CATALOGSEARCHINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "BkTree.h"
+
+// Inverted index for partial and typo-tolerant title and author search.
+//
+// A book's title and author are case-folded and split into words (letters and digits).
+// Every word contributes its bigrams and trigrams plus word-start grams (" a", " ab"),
+// and each gram has a posting list of library IDs in ascending order. A query walks the
+// rarest of its grams' lists, galloping through the others in step, and checks each
+// candidate's text, since sharing every gram does not guarantee a match. Fuzzy queries
+// first correct each word against a BK-tree of the indexed words, then run as WORD
+// queries over the corrected spellings.
+// Not synchronized: the owner guards it.
+class CatalogSearchIndex {
+public:
+    enum MatchMode {
+        PREFIX,    // every query word starts some word of the title or author
+        SUBSTRING, // every query word occurs anywhere in the title or author
+        WORD       // every query word is a whole word of the title or author
+    };
+
+    struct FuzzyMatch {
+        int libraryID;
+        int distance; // edits summed over the query words
+    };
+
+    struct Entry {
+        int libraryID;
+        std::string_view title;
+        std::string_view author;
+    };
+
+    // Indexes a book, replacing what was indexed under its ID before
+    void Add(int libraryID, std::string_view title, std::string_view author);
+    void Remove(int libraryID);
+
+    // Indexes many books with distinct IDs that are not indexed yet
+    void AddBulk(std::vector<Entry> entries);
+
+    // Library IDs of up to maxResults matching books, in ascending order. A query with no
+    // words matches nothing.
+    std::vector<int> Search(std::string_view query, MatchMode mode, std::size_t maxResults) const;
+
+    // Typo-tolerant search: each query word may be replaced by an indexed word within
+    // maxEdits edits (at most one for words of up to four letters). Returns up to
+    // maxResults books whose title or author holds a corrected spelling of every query
+    // word, fewest total edits first.
+    std::vector<FuzzyMatch> FuzzySearch(std::string_view query, int maxEdits, std::size_t maxResults) const;
+
+    // Case-folded words of a text, the form queries and documents are matched in
+    static std::vector<std::string> Words(std::string_view text);
+
+    // Grams are three symbols from [ a-z0-9] plus padding, numbered densely so the
+    // posting lists live in one flat table
+    static const std::uint32_t SYMBOLS = 38;
+    static const std::uint32_t GRAMS = SYMBOLS * SYMBOLS * SYMBOLS;
+
+private:
+    static void GramsOf(std::string_view text, std::vector<std::uint32_t>& grams);
+    void AddGrams(int libraryID, const std::string& text);
+
+    std::vector<std::vector<int>> postings = std::vector<std::vector<int>>(GRAMS);
+    std::unordered_map<int, std::string> texts; // " word word ...": normalized title then author
+    BkTree vocabulary;                          // every word of every text, for FuzzySearch
+};
+
+#endif // CATALOGSEARCHINDEX_H
@@ -0,0 +1,10 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32 (IEEE 802.3) of a byte range, used to detect torn or corrupt records on disk
+std::uint32_t Crc32(const char* data, std::size_t length);
+
+#endif // CHECKSUM_H
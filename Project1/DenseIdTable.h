@@ -0,0 +1,146 @@
+#ifndef DENSEIDTABLE_H
+#define DENSEIDTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Epoch.h"
+
+// Pointers addressed directly by a sequentially assigned ID: the slot is ID - base, so a
+// lookup is a bounds check and two dependent loads, with no hashing or probing. Like
+// RcuHashMap, readers never block: one writer at a time (serialized by the owner), any
+// number of concurrent readers inside an Epoch::ReadGuard.
+//
+// Slots live in fixed-size pages reached through a page directory. Pages never move;
+// growing the directory publishes a copy and retires the old one. IDs are not reused, so
+// Erase leaves a tombstone (a null slot), and a page whose slots are all tombstones is
+// released, which keeps long-deleted ID ranges from holding memory.
+//
+// Each slot also carries an Aux value for the writer (such as the handle of the slot that
+// owns the record); readers only see the pointer.
+template <typename T, typename Aux>
+class DenseIdTable {
+public:
+    explicit DenseIdTable(int base = 0) : base(base), directory(new Directory(0)) {}
+    ~DenseIdTable() {
+        Directory* current = directory.load(std::memory_order_relaxed);
+        for (std::size_t p = 0; p < current->size; ++p) delete current->pages[p].load(std::memory_order_relaxed);
+        delete current;
+    }
+    DenseIdTable(const DenseIdTable&) = delete;
+    DenseIdTable& operator=(const DenseIdTable&) = delete;
+
+    // Reader (inside a ReadGuard) or writer: the pointer stored for id, or nullptr
+    T* Find(int id) const {
+        const Slot* slot = SlotFor(id);
+        return slot ? slot->value.load(std::memory_order_acquire) : nullptr;
+    }
+
+    // Writer: the pointer and aux value stored for id; false if there is none
+    bool Get(int id, T*& value, Aux& aux) const {
+        const Slot* slot = SlotFor(id);
+        if (!slot || !slot->value.load(std::memory_order_relaxed)) return false;
+        value = slot->value.load(std::memory_order_relaxed);
+        aux = slot->aux;
+        return true;
+    }
+
+    // Writer: stores a (non-null) pointer and its aux value for id; false if id is below base
+    bool Set(int id, T* value, Aux aux) {
+        if (static_cast<std::int64_t>(id) < base) return false;
+        const std::size_t index = static_cast<std::size_t>(static_cast<std::int64_t>(id) - base);
+        Directory* current = Grow(index / PAGE_SIZE + 1);
+        std::atomic<Page*>& entry = current->pages[index / PAGE_SIZE];
+        Page* page = entry.load(std::memory_order_relaxed);
+        if (!page) {
+            page = new Page();
+            entry.store(page, std::memory_order_release);
+        }
+        Slot& slot = page->slots[index % PAGE_SIZE];
+        if (!slot.value.load(std::memory_order_relaxed)) {
+            ++page->live;
+            ++count;
+        }
+        slot.aux = aux; // readers never look at aux
+        slot.value.store(value, std::memory_order_release);
+        return true;
+    }
+
+    // Writer: tombstones id; returns false if it was empty
+    bool Erase(int id) {
+        Slot* slot = const_cast<Slot*>(SlotFor(id));
+        if (!slot || !slot->value.load(std::memory_order_relaxed)) return false;
+        slot->value.store(nullptr, std::memory_order_release);
+        slot->aux = Aux();
+        --count;
+
+        const std::size_t p = static_cast<std::size_t>(static_cast<std::int64_t>(id) - base) / PAGE_SIZE;
+        std::atomic<Page*>& entry = directory.load(std::memory_order_relaxed)->pages[p];
+        Page* page = entry.load(std::memory_order_relaxed);
+        if (--page->live == 0) {
+            entry.store(nullptr, std::memory_order_release);
+            retired.Retire([page] { delete page; });
+        }
+        return true;
+    }
+
+    // Writer: sizes the directory for IDs below base + expected up front
+    void Reserve(std::size_t expected) { Grow((expected + PAGE_SIZE - 1) / PAGE_SIZE); }
+
+    std::size_t Size() const { return count.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t PAGE_SIZE = 4096;
+
+    struct Slot {
+        std::atomic<T*> value{ nullptr };
+        Aux aux{};
+    };
+
+    struct Page {
+        Slot slots[PAGE_SIZE];
+        std::size_t live = 0; // non-tombstone slots (writer only)
+    };
+
+    struct Directory {
+        explicit Directory(std::size_t size) : size(size), pages(new std::atomic<Page*>[size]) {
+            for (std::size_t p = 0; p < size; ++p) pages[p].store(nullptr, std::memory_order_relaxed);
+        }
+        std::size_t size;
+        std::unique_ptr<std::atomic<Page*>[]> pages;
+    };
+
+    // Slot for id in the current directory, or nullptr if its page is absent
+    const Slot* SlotFor(int id) const {
+        if (static_cast<std::int64_t>(id) < base) return nullptr;
+        const std::size_t index = static_cast<std::size_t>(static_cast<std::int64_t>(id) - base);
+        const Directory* current = directory.load(std::memory_order_acquire);
+        if (index / PAGE_SIZE >= current->size) return nullptr;
+        const Page* page = current->pages[index / PAGE_SIZE].load(std::memory_order_acquire);
+        return page ? &page->slots[index % PAGE_SIZE] : nullptr;
+    }
+
+    // Publishes a directory with room for at least pageCount pages (doubling) and retires
+    // the old one; the pages themselves are shared, not copied
+    Directory* Grow(std::size_t pageCount) {
+        Directory* current = directory.load(std::memory_order_relaxed);
+        if (pageCount <= current->size) return current;
+        std::size_t size = current->size ? current->size : 16;
+        while (size < pageCount) size *= 2;
+        Directory* grown = new Directory(size);
+        for (std::size_t p = 0; p < current->size; ++p) {
+            grown->pages[p].store(current->pages[p].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        directory.store(grown, std::memory_order_release);
+        retired.Retire([current] { delete current; });
+        return grown;
+    }
+
+    const std::int64_t base;
+    std::atomic<Directory*> directory;
+    std::atomic<std::size_t> count{ 0 };
+    RetireList retired; // released pages and replaced directories, never the live ones
+};
+
+#endif // DENSEIDTABLE_H
@@ -0,0 +1,50 @@
+#include "EditDistance.h"
+#include <algorithm>
+#include <vector>
+
+EditDistance::EditDistance(std::string_view pattern) : pattern(pattern) {
+    if (pattern.size() > 64) return;
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        matchMasks[static_cast<unsigned char>(pattern[i])] |= std::uint64_t(1) << i;
+    }
+}
+
+int EditDistance::To(std::string_view text) const {
+    const std::size_t m = pattern.size();
+    if (m == 0) return static_cast<int>(text.size());
+    if (m > 64) return ByRows(text);
+
+    // Pv/Mv: vertical deltas (+1/-1) down the current column; score tracks the last row
+    const std::uint64_t last = std::uint64_t(1) << (m - 1);
+    std::uint64_t pv = ~std::uint64_t(0);
+    std::uint64_t mv = 0;
+    int score = static_cast<int>(m);
+    for (unsigned char c : text) {
+        const std::uint64_t eq = matchMasks[c];
+        const std::uint64_t xv = eq | mv;
+        const std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        std::uint64_t ph = mv | ~(xh | pv);
+        std::uint64_t mh = pv & xh;
+        if (ph & last) ++score;
+        else if (mh & last) --score;
+        ph = (ph << 1) | 1; // row 0 grows by one per text character
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+    return score;
+}
+
+int EditDistance::ByRows(std::string_view text) const {
+    std::vector<int> previous(text.size() + 1), current(text.size() + 1);
+    for (std::size_t j = 0; j <= text.size(); ++j) previous[j] = static_cast<int>(j);
+    for (std::size_t i = 1; i <= pattern.size(); ++i) {
+        current[0] = static_cast<int>(i);
+        for (std::size_t j = 1; j <= text.size(); ++j) {
+            int substitution = previous[j - 1] + (pattern[i - 1] == text[j - 1] ? 0 : 1);
+            current[j] = std::min({ substitution, previous[j] + 1, current[j - 1] + 1 });
+        }
+        previous.swap(current);
+    }
+    return previous[text.size()];
+}
@@ -0,0 +1,28 @@
+#ifndef EDITDISTANCE_H
+#define EDITDISTANCE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Levenshtein distance from one fixed pattern to many texts.
+//
+// Patterns of up to 64 characters use Myers' bit-parallel algorithm (Hyyro's
+// formulation): one DP column is a pair of 64-bit delta vectors, so each text character
+// costs a handful of word operations instead of a column of cell updates. Longer
+// patterns fall back to the two-row DP.
+class EditDistance {
+public:
+    explicit EditDistance(std::string_view pattern);
+
+    int To(std::string_view text) const;
+
+private:
+    int ByRows(std::string_view text) const;
+
+    std::string pattern;
+    std::array<std::uint64_t, 256> matchMasks{}; // bit i set where pattern[i] == c
+};
+
+#endif // EDITDISTANCE_H
@@ -0,0 +1,101 @@
+#include "Epoch.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
+
+// helpers (file-local)
+namespace {
+
+std::atomic<std::uint64_t> globalEpoch{ 1 };
+
+// One slot per reader thread: the epoch it has pinned, or 0 when it holds no guard
+struct alignas(64) ReaderSlot {
+    std::atomic<std::uint64_t> epoch{ 0 };
+    std::atomic<bool> owned{ false };
+};
+std::array<ReaderSlot, Epoch::MAX_READERS> readerSlots;
+
+// Claims a reader slot for the calling thread on first use and frees it at thread exit
+class ThreadSlot {
+public:
+    ReaderSlot& Get() {
+        if (!slot) slot = Claim();
+        return *slot;
+    }
+    ~ThreadSlot() {
+        if (slot) slot->owned.store(false, std::memory_order_release);
+    }
+    int depth = 0; // nested guards on this thread
+
+private:
+    static ReaderSlot* Claim() {
+        while (true) {
+            for (ReaderSlot& candidate : readerSlots) {
+                bool expected = false;
+                if (!candidate.owned.load(std::memory_order_relaxed)
+                    && candidate.owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    return &candidate;
+                }
+            }
+            std::this_thread::yield(); // every slot taken: wait for a reader thread to exit
+        }
+    }
+
+    ReaderSlot* slot = nullptr;
+};
+
+thread_local ThreadSlot threadSlot;
+
+} // namespace
+
+Epoch::ReadGuard::ReadGuard() {
+    if (threadSlot.depth++ > 0) return;
+    ReaderSlot& slot = threadSlot.Get();
+    // Publish the pin, then re-check: if the epoch moved meanwhile, a collector may have
+    // scanned before seeing the pin, so pin the newer epoch instead.
+    std::uint64_t epoch = globalEpoch.load();
+    while (true) {
+        slot.epoch.store(epoch);
+        std::uint64_t now = globalEpoch.load();
+        if (now == epoch) break;
+        epoch = now;
+    }
+}
+
+Epoch::ReadGuard::~ReadGuard() {
+    if (--threadSlot.depth > 0) return;
+    threadSlot.Get().epoch.store(0, std::memory_order_release);
+}
+
+std::uint64_t Epoch::Current() {
+    return globalEpoch.load();
+}
+
+std::uint64_t Epoch::Advance() {
+    std::uint64_t oldest = globalEpoch.fetch_add(1) + 1;
+    for (const ReaderSlot& slot : readerSlots) {
+        std::uint64_t pinned = slot.epoch.load();
+        if (pinned != 0 && pinned < oldest) oldest = pinned;
+    }
+    return oldest;
+}
+
+RetireList::~RetireList() {
+    for (Entry& entry : pending) entry.reclaim();
+}
+
+void RetireList::Retire(std::function<void()> reclaim) {
+    pending.push_back({ Epoch::Current(), std::move(reclaim) });
+    if (pending.size() >= COLLECT_THRESHOLD) Collect();
+}
+
+void RetireList::Collect() {
+    if (pending.empty()) return;
+    const std::uint64_t oldest = Epoch::Advance();
+    auto keep = std::stable_partition(pending.begin(), pending.end(),
+                                      [oldest](const Entry& entry) { return entry.epoch >= oldest; });
+    std::vector<Entry> ready(std::make_move_iterator(keep), std::make_move_iterator(pending.end()));
+    pending.erase(keep, pending.end());
+    for (Entry& entry : ready) entry.reclaim();
+}
@@ -0,0 +1,65 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Epoch-based reclamation for the lock-free read paths.
+//
+// A reader holds an Epoch::ReadGuard while it uses pointers taken from a lock-free
+// structure; the guard pins the global epoch for its thread. A writer that unlinks an
+// object hands it to a RetireList instead of freeing it, and the object is only freed
+// once every reader that pinned an epoch at or before the unlink has left its guard.
+class Epoch {
+public:
+    // Pins the current epoch for this thread. Guards nest; only the outermost one pins.
+    class ReadGuard {
+    public:
+        ReadGuard();
+        ~ReadGuard();
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+    };
+
+    // Epoch a writer records when it retires an object
+    static std::uint64_t Current();
+
+    // Starts a new epoch and returns the oldest epoch a reader may still be pinned at.
+    // Objects retired in an epoch older than the result are unreachable by every reader.
+    static std::uint64_t Advance();
+
+    // Most threads that may hold a ReadGuard at the same time
+    static const std::size_t MAX_READERS = 256;
+};
+
+// Objects a writer has unlinked, waiting until no reader can still see them.
+// Not synchronized: use it from the (single, serialized) writer side only.
+class RetireList {
+public:
+    // Collect runs automatically once this many objects are waiting
+    static const std::size_t COLLECT_THRESHOLD = 64;
+
+    RetireList() = default;
+    ~RetireList(); // runs every pending reclaim; no readers may remain
+    RetireList(const RetireList&) = delete;
+    RetireList& operator=(const RetireList&) = delete;
+
+    // Schedules reclaim() to run once no reader can still see the retired object
+    void Retire(std::function<void()> reclaim);
+
+    // Runs the reclaims whose objects no reader can see any more
+    void Collect();
+
+    std::size_t Pending() const { return pending.size(); }
+
+private:
+    struct Entry {
+        std::uint64_t epoch;
+        std::function<void()> reclaim;
+    };
+    std::vector<Entry> pending;
+};
+
+#endif // EPOCH_H
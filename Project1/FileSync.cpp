@@ -0,0 +1,56 @@
+#include "FileSync.h"
+#include <filesystem>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// helpers (file-local)
+namespace {
+
+// Forces a closed file's data to disk; any handle with write access flushes the file
+bool syncPath(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+    if (!file) return false;
+    const bool synced = SyncFile(file);
+    return std::fclose(file) == 0 && synced;
+}
+
+// Makes a rename inside the directory durable. NTFS journals renames itself, and Windows
+// cannot open a directory as a file, so there is nothing to do there.
+bool syncDirectoryOf(const std::string& path) {
+#if defined(_WIN32)
+    (void)path;
+    return true;
+#else
+    std::filesystem::path dir = std::filesystem::path(path).parent_path();
+    if (dir.empty()) dir = std::filesystem::path(".");
+    const int fd = open(dir.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    const bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+#endif
+}
+
+} // namespace
+
+bool SyncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) return false;
+#if defined(_WIN32)
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool DurableRename(const std::string& tmpPath, const std::string& path) {
+    if (!syncPath(tmpPath)) return false;
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) return false;
+    return syncDirectoryOf(path);
+}
@@ -0,0 +1,14 @@
+#ifndef FILESYNC_H
+#define FILESYNC_H
+
+#include <cstdio>
+#include <string>
+
+// Flushes a stdio stream and forces its data to disk (fsync, or _commit on Windows)
+bool SyncFile(std::FILE* file);
+
+// Replaces path with tmpPath so that a power loss leaves either the old or the new file
+// whole: tmpPath's data is forced to disk before the rename, and the directory entry after.
+bool DurableRename(const std::string& tmpPath, const std::string& path);
+
+#endif // FILESYNC_H
@@ -0,0 +1,77 @@
+#include "FineLedger.h"
+#include <algorithm>
+
+void FineLedger::Start(int loanID, int patronID, std::int64_t dueEpoch, std::int64_t now) {
+    if (now <= dueEpoch) return;
+    Drop(loanID);
+    Accrual& accrual = accruals[loanID];
+    accrual = Accrual{ patronID, LibraryCalendar::LocalDay(dueEpoch), 0, 0 };
+    Charge(loanID, accrual, now);
+}
+
+void FineLedger::Charge(int loanID, Accrual& accrual, std::int64_t now) {
+    const std::int64_t today = LibraryCalendar::LocalDay(now);
+    const std::int64_t days = calendar.OpenDaysAfter(accrual.dueDay, today);
+    const std::int64_t cents = std::min(days * policy.centsPerDay, policy.maxCentsPerLoan);
+    if (cents > accrual.cents) {
+        accruingByPatron[accrual.patronID] += cents - accrual.cents;
+        accrual.cents = cents;
+    }
+    accrual.nextEpoch = 0;
+    if (cents < policy.maxCentsPerLoan) {
+        accrual.nextEpoch = LibraryCalendar::LocalStartOfDay(calendar.NextOpenDay(today + 1));
+        boundaries.push(Boundary(accrual.nextEpoch, loanID));
+    }
+}
+
+void FineLedger::AccrueUntil(std::int64_t now) {
+    while (!boundaries.empty() && boundaries.top().first < now) {
+        Boundary next = boundaries.top();
+        boundaries.pop();
+        auto it = accruals.find(next.second);
+        if (it == accruals.end() || it->second.nextEpoch != next.first) continue; // stale entry
+        Charge(next.second, it->second, now);
+    }
+
+    // Entries left behind by dropped loans are only skipped when popped; rebuild once
+    // they dominate the heap
+    if (boundaries.size() > 2 * accruals.size() + 64) {
+        std::vector<Boundary> live;
+        live.reserve(accruals.size());
+        for (const auto& [loanID, accrual] : accruals) {
+            if (accrual.nextEpoch != 0) live.push_back(Boundary(accrual.nextEpoch, loanID));
+        }
+        boundaries = decltype(boundaries)(std::greater<Boundary>(), std::move(live));
+    }
+}
+
+std::int64_t FineLedger::Settle(int loanID, std::int64_t now) {
+    auto it = accruals.find(loanID);
+    if (it == accruals.end()) return 0;
+    Charge(loanID, it->second, now);
+    const std::int64_t cents = it->second.cents;
+    Forget(loanID, it->second);
+    return cents;
+}
+
+void FineLedger::Drop(int loanID) {
+    auto it = accruals.find(loanID);
+    if (it != accruals.end()) Forget(loanID, it->second);
+}
+
+void FineLedger::Forget(int loanID, const Accrual& accrual) {
+    auto total = accruingByPatron.find(accrual.patronID);
+    if (total != accruingByPatron.end() && (total->second -= accrual.cents) <= 0) accruingByPatron.erase(total);
+    accruals.erase(loanID);
+}
+
+std::int64_t FineLedger::AccruingFor(int patronID) const {
+    auto it = accruingByPatron.find(patronID);
+    return it != accruingByPatron.end() ? it->second : 0;
+}
+
+void FineLedger::Clear() {
+    accruals.clear();
+    accruingByPatron.clear();
+    boundaries = decltype(boundaries)();
+}
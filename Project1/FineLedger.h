@@ -0,0 +1,78 @@
+#ifndef FINELEDGER_H
+#define FINELEDGER_H
+
+#include <cstdint>
+#include "LibraryCalendar.h"
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Late fees, in cents
+struct FinePolicy {
+    std::int64_t centsPerDay = 25;      // charged for each open day after the due date
+    std::int64_t maxCentsPerLoan = 1000; // a loan stops accruing once it reaches this
+};
+
+// Fines accruing on overdue loans that are still out.
+//
+// A loan's fine is centsPerDay times the days the library has been open since its due
+// date (LibraryCalendar), capped at maxCentsPerLoan. Rather than recomputing that for
+// every loan, each overdue loan has the start of its next open day in a min-heap and
+// AccrueUntil only visits loans whose day has come, catching up however many days went
+// by in one step. Per-patron running totals are kept alongside, so "does this patron
+// owe anything" is one hash lookup.
+//
+// Settle hands a loan's final fine to the caller (for the patron's balance) when it is
+// checked in or renewed. The ledger is derived state: it is rebuilt from the loans'
+// due dates after a load and never persisted. Not thread-safe; LoansCollection calls it
+// under loansMutex.
+class FineLedger {
+public:
+    explicit FineLedger(const LibraryCalendar& calendar) : calendar(calendar) {}
+
+    void SetPolicy(const FinePolicy& policy) { this->policy = policy; }
+    const FinePolicy& Policy() const { return policy; }
+
+    // Starts accruing for a loan that is past due at now
+    void Start(int loanID, int patronID, std::int64_t dueEpoch, std::int64_t now);
+
+    // Brings every accruing loan up to now
+    void AccrueUntil(std::int64_t now);
+
+    // Final fine of a loan at now, in cents; the loan stops accruing (0 if it never did)
+    std::int64_t Settle(int loanID, std::int64_t now);
+
+    // Stops accruing for a loan without charging it
+    void Drop(int loanID);
+
+    // Fines accrued so far on a patron's loans that are still out, in cents
+    std::int64_t AccruingFor(int patronID) const;
+
+    void Clear();
+
+private:
+    struct Accrual {
+        int patronID;
+        std::int64_t dueDay;    // LibraryCalendar day number of the due date
+        std::int64_t cents;     // charged so far
+        std::int64_t nextEpoch; // when the next open day's charge starts, 0 once capped
+    };
+
+    // Charges an accrual up to now and reschedules it
+    void Charge(int loanID, Accrual& accrual, std::int64_t now);
+    void Forget(int loanID, const Accrual& accrual);
+
+    const LibraryCalendar& calendar;
+    FinePolicy policy;
+    std::unordered_map<int, Accrual> accruals;             // loan ID -> accrual
+    std::unordered_map<int, std::int64_t> accruingByPatron; // patron ID -> sum of cents
+
+    // Min-heap of (start of next open day, loan ID); entries of dropped or recharged
+    // loans are skipped when popped
+    using Boundary = std::pair<std::int64_t, int>;
+    std::priority_queue<Boundary, std::vector<Boundary>, std::greater<Boundary>> boundaries;
+};
+
+#endif // FINELEDGER_H
@@ -0,0 +1,179 @@
+#include "HoldQueues.h"
+#include <algorithm>
+
+std::uint32_t HoldQueues::Allocate(const Hold& hold) {
+    std::uint32_t n;
+    if (freeHead != NIL) {
+        n = freeHead;
+        freeHead = pool[n].next;
+    } else {
+        n = static_cast<std::uint32_t>(pool.size());
+        pool.emplace_back();
+    }
+    pool[n].hold = hold;
+    pool[n].prev = pool[n].next = NIL;
+    byID[hold.holdID] = n;
+    byPatron[hold.patronID].push_back(n);
+    return n;
+}
+
+void HoldQueues::Free(std::uint32_t n) {
+    const Hold& hold = pool[n].hold;
+    auto byOwner = byPatron.find(hold.patronID);
+    if (byOwner != byPatron.end()) {
+        auto& nodes = byOwner->second;
+        nodes.erase(std::remove(nodes.begin(), nodes.end(), n), nodes.end());
+        if (nodes.empty()) byPatron.erase(byOwner);
+    }
+    byID.erase(hold.holdID);
+    pool[n].hold = Hold{};
+    pool[n].prev = NIL;
+    pool[n].next = freeHead;
+    freeHead = n;
+}
+
+void HoldQueues::Enqueue(std::uint32_t n) {
+    Node& node = pool[n];
+    node.hold.priority = std::clamp(node.hold.priority, 0, PRIORITY_LEVELS - 1);
+    TitleQueue& queue = queues[node.hold.isbn];
+    const int level = node.hold.priority;
+    node.prev = queue.tail[level];
+    node.next = NIL;
+    if (queue.tail[level] != NIL) pool[queue.tail[level]].next = n;
+    else queue.head[level] = n;
+    queue.tail[level] = n;
+    ++queue.waiting;
+}
+
+void HoldQueues::Unlink(std::uint32_t n) {
+    Node& node = pool[n];
+    auto it = queues.find(node.hold.isbn);
+    if (it == queues.end()) return;
+    TitleQueue& queue = it->second;
+    const int level = node.hold.priority;
+    if (node.prev != NIL) pool[node.prev].next = node.next;
+    else queue.head[level] = node.next;
+    if (node.next != NIL) pool[node.next].prev = node.prev;
+    else queue.tail[level] = node.prev;
+    node.prev = node.next = NIL;
+    if (--queue.waiting == 0) queues.erase(it);
+}
+
+void HoldQueues::MarkReady(std::uint32_t n) {
+    const Hold& hold = pool[n].hold;
+    readyByBook[hold.bookID] = n;
+    expiries.push(Expiry(hold.expiresEpoch, hold.holdID));
+    CompactExpiries();
+}
+
+int HoldQueues::Place(int patronID, std::uint64_t isbn, int priority, std::int64_t now) {
+    Hold hold;
+    hold.holdID = nextHoldID++;
+    hold.patronID = patronID;
+    hold.isbn = isbn;
+    hold.priority = priority;
+    hold.placedEpoch = now;
+    Enqueue(Allocate(hold));
+    return hold.holdID;
+}
+
+void HoldQueues::Restore(const Hold& hold) {
+    nextHoldID = std::max(nextHoldID, hold.holdID + 1);
+    auto it = byID.find(hold.holdID);
+    if (it != byID.end()) {
+        const std::uint32_t n = it->second;
+        const Hold& current = pool[n].hold;
+        if (current.status == Hold::WAITING && hold.status == Hold::WAITING && current.isbn == hold.isbn
+            && current.priority == hold.priority) {
+            return; // already in place; keep its spot in line
+        }
+        Remove(hold.holdID);
+    }
+    const std::uint32_t n = Allocate(hold);
+    if (hold.status == Hold::READY) MarkReady(n);
+    else Enqueue(n);
+}
+
+bool HoldQueues::Remove(int holdID) {
+    auto it = byID.find(holdID);
+    if (it == byID.end()) return false;
+    const std::uint32_t n = it->second;
+    const Hold& hold = pool[n].hold;
+    if (hold.status == Hold::WAITING) {
+        Unlink(n);
+    } else {
+        auto ready = readyByBook.find(hold.bookID);
+        if (ready != readyByBook.end() && ready->second == n) readyByBook.erase(ready);
+    }
+    Free(n);
+    return true;
+}
+
+const Hold* HoldQueues::AssignNext(std::uint64_t isbn, int bookID, std::int64_t expiresEpoch) {
+    auto it = queues.find(isbn);
+    if (it == queues.end()) return nullptr;
+    std::uint32_t n = NIL;
+    for (int level = PRIORITY_LEVELS - 1; level >= 0 && n == NIL; --level) n = it->second.head[level];
+    if (n == NIL) return nullptr;
+
+    Unlink(n);
+    Hold& hold = pool[n].hold;
+    hold.status = Hold::READY;
+    hold.bookID = bookID;
+    hold.expiresEpoch = expiresEpoch;
+    MarkReady(n);
+    return &hold;
+}
+
+const Hold* HoldQueues::Find(int holdID) const {
+    auto it = byID.find(holdID);
+    return it != byID.end() ? &pool[it->second].hold : nullptr;
+}
+
+const Hold* HoldQueues::FindForPatron(int patronID, std::uint64_t isbn) const {
+    auto it = byPatron.find(patronID);
+    if (it == byPatron.end()) return nullptr;
+    for (std::uint32_t n : it->second) {
+        if (pool[n].hold.isbn == isbn) return &pool[n].hold;
+    }
+    return nullptr;
+}
+
+const Hold* HoldQueues::ReadyFor(int bookID) const {
+    auto it = readyByBook.find(bookID);
+    return it != readyByBook.end() ? &pool[it->second].hold : nullptr;
+}
+
+std::size_t HoldQueues::Waiting(std::uint64_t isbn) const {
+    auto it = queues.find(isbn);
+    return it != queues.end() ? it->second.waiting : 0;
+}
+
+void HoldQueues::TakeExpired(std::int64_t now, std::vector<int>& holdIDs) {
+    while (!expiries.empty() && expiries.top().first <= now) {
+        const Expiry entry = expiries.top();
+        expiries.pop();
+        const Hold* hold = Find(entry.second);
+        if (!hold || hold->status != Hold::READY || hold->expiresEpoch != entry.first) continue; // stale entry
+        holdIDs.push_back(entry.second);
+    }
+}
+
+void HoldQueues::CompactExpiries() {
+    if (expiries.size() <= 2 * readyByBook.size() + 64) return;
+
+    std::vector<Expiry> live;
+    live.reserve(readyByBook.size());
+    for (const auto& entry : readyByBook) live.push_back(Expiry(pool[entry.second].hold.expiresEpoch, pool[entry.second].hold.holdID));
+    expiries = decltype(expiries)(std::greater<Expiry>(), std::move(live));
+}
+
+void HoldQueues::Clear() {
+    pool.clear();
+    freeHead = NIL;
+    byID.clear();
+    queues.clear();
+    readyByBook.clear();
+    byPatron.clear();
+    expiries = decltype(expiries)();
+}
@@ -0,0 +1,134 @@
+#ifndef HOLDQUEUES_H
+#define HOLDQUEUES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// A patron's request for the next copy of a title that comes back
+struct Hold {
+    enum HoldStatus { WAITING, READY };
+
+    int holdID = 0;
+    int patronID = 0;
+    std::uint64_t isbn = 0;        // packed (see Books::PackISBN); any copy of the title serves
+    int priority = 0;              // higher levels are served first, FIFO within a level
+    HoldStatus status = WAITING;
+    std::int64_t placedEpoch = 0;
+    int bookID = 0;                // the copy set aside, once READY
+    std::int64_t expiresEpoch = 0; // pickup deadline, once READY
+};
+
+// Hold queues for every title.
+//
+// Holds live in one pooled array of nodes that is recycled through a free list. A waiting
+// hold is linked into its title's queue for its priority level (the prev/next links are in
+// the node itself), so placing, cancelling and serving a hold are O(1) however many holds
+// a title has: serving takes the head of the highest non-empty level. A served hold is
+// READY: it is unlinked from its queue, indexed by the copy set aside for it, and its pickup
+// deadline goes into a min-heap that TakeExpired pops. Heap entries of holds that were
+// picked up or cancelled are skipped when popped, as in the loans' due queue.
+//
+// Not thread-safe; LoansCollection calls it under loansMutex.
+class HoldQueues {
+public:
+    static const int PRIORITY_LEVELS = 2; // 0 = regular, 1 = priority
+
+    // Queues a new hold at the back of its title's queue; returns its ID
+    int Place(int patronID, std::uint64_t isbn, int priority, std::int64_t now);
+
+    // Stores a hold's exact fields, inserting or overwriting (snapshot load, journal replay).
+    // A new waiting hold joins the back of its queue, so restoring in queue order keeps it.
+    void Restore(const Hold& hold);
+
+    // Removes a hold, waiting or ready; false if there is none
+    bool Remove(int holdID);
+
+    // Sets bookID aside for the next waiting hold on isbn, to be picked up by
+    // expiresEpoch; returns that hold, or nullptr if nobody is waiting
+    const Hold* AssignNext(std::uint64_t isbn, int bookID, std::int64_t expiresEpoch);
+
+    const Hold* Find(int holdID) const;
+    // The patron's hold on a title, waiting or ready
+    const Hold* FindForPatron(int patronID, std::uint64_t isbn) const;
+    // The ready hold a copy is set aside for
+    const Hold* ReadyFor(int bookID) const;
+
+    // Holds waiting on a title
+    std::size_t Waiting(std::uint64_t isbn) const;
+    std::size_t Size() const { return byID.size(); }
+
+    // Pops the pickup deadlines at or before now and appends the IDs of the holds that
+    // are still ready under them (the holds themselves are left for the caller to remove)
+    void TakeExpired(std::int64_t now, std::vector<int>& holdIDs);
+
+    int NextHoldID() const { return nextHoldID; }
+    void SetNextHoldID(int id) { nextHoldID = id; }
+
+    void Clear();
+
+    // Visits every hold: each title's waiting holds in serving order, then the ready ones
+    template <typename Fn>
+    void ForEach(Fn fn) const {
+        for (const auto& entry : queues) {
+            for (int level = PRIORITY_LEVELS - 1; level >= 0; --level) {
+                for (std::uint32_t n = entry.second.head[level]; n != NIL; n = pool[n].next) fn(pool[n].hold);
+            }
+        }
+        for (const auto& entry : readyByBook) fn(pool[entry.second].hold);
+    }
+
+    // Visits a patron's holds
+    template <typename Fn>
+    void ForPatron(int patronID, Fn fn) const {
+        auto it = byPatron.find(patronID);
+        if (it == byPatron.end()) return;
+        for (std::uint32_t n : it->second) fn(pool[n].hold);
+    }
+
+private:
+    static constexpr std::uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Node {
+        Hold hold;
+        std::uint32_t prev = NIL; // neighbours in the title's queue while WAITING;
+        std::uint32_t next = NIL; // next is the free-list link while the node is unused
+    };
+
+    struct TitleQueue {
+        TitleQueue() {
+            head.fill(NIL);
+            tail.fill(NIL);
+        }
+        std::array<std::uint32_t, PRIORITY_LEVELS> head; // per priority level
+        std::array<std::uint32_t, PRIORITY_LEVELS> tail;
+        std::size_t waiting = 0;
+    };
+
+    std::uint32_t Allocate(const Hold& hold);
+    void Free(std::uint32_t n);
+    void Enqueue(std::uint32_t n);
+    void Unlink(std::uint32_t n);
+    void MarkReady(std::uint32_t n);
+    void CompactExpiries();
+
+    std::vector<Node> pool;
+    std::uint32_t freeHead = NIL;
+    int nextHoldID = 1;
+
+    std::unordered_map<int, std::uint32_t> byID;                      // hold ID -> node
+    std::unordered_map<std::uint64_t, TitleQueue> queues;             // ISBN -> waiting holds
+    std::unordered_map<int, std::uint32_t> readyByBook;               // book ID -> ready hold
+    std::unordered_map<int, std::vector<std::uint32_t>> byPatron;     // patron ID -> holds
+
+    // Min-heap of (pickup deadline, hold ID) for ready holds
+    using Expiry = std::pair<std::int64_t, int>;
+    std::priority_queue<Expiry, std::vector<Expiry>, std::greater<Expiry>> expiries;
+};
+
+#endif // HOLDQUEUES_H
@@ -0,0 +1,387 @@
+#include "Journal.h"
+#include "Checksum.h"
+#include "FileSync.h"
+#include "MappedFile.h"
+#include "PatronsCollection.h"
+#include "BooksCollection.h"
+#include "LoansCollection.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+// helpers (file-local)
+namespace {
+
+const std::size_t FRAME_HEADER = 8; // payload length + CRC-32
+
+// Records logged by this thread since its last Commit
+thread_local std::string pendingRecords;
+thread_local std::uint32_t pendingCount = 0;
+
+// Payload encoding: fixed-width little-endian fields, strings as length + bytes
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void putString(std::string& out, std::string_view s) {
+    put<std::uint32_t>(out, static_cast<std::uint32_t>(s.size()));
+    out += s;
+}
+
+// Bounds-checked reader over one record payload
+class PayloadReader {
+public:
+    PayloadReader(const char* data, std::size_t size) : data(data), size(size), pos(0), ok(true) {}
+
+    template <typename T>
+    T get() {
+        T value{};
+        if (size - pos < sizeof(T)) { ok = false; return value; }
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    std::string getString() {
+        std::uint32_t length = get<std::uint32_t>();
+        if (!ok || size - pos < length) { ok = false; return std::string(); }
+        std::string s(data + pos, length);
+        pos += length;
+        return s;
+    }
+
+    bool good() const { return ok; }
+    bool atEnd() const { return pos == size; }
+
+private:
+    const char* data;
+    std::size_t size;
+    std::size_t pos;
+    bool ok;
+};
+
+// Applies one record body ([type][payload]); false if its payload does not parse
+bool applyRecord(const char* body, std::size_t length, PatronsCollection& patrons, BooksCollection& books,
+                 LoansCollection& loans) {
+    PayloadReader in(body + 1, length - 1);
+    switch (static_cast<Journal::RecordType>(body[0])) {
+        case Journal::BOOK_PUT: {
+            int id = in.get<std::int32_t>();
+            float cost = in.get<float>();
+            auto status = static_cast<Books::BookStatus>(in.get<std::uint8_t>());
+            std::string author = in.getString();
+            std::string title = in.getString();
+            std::string isbn = in.getString();
+            auto material = in.atEnd() ? Books::BOOK : static_cast<Books::Material>(in.get<std::uint8_t>());
+            if (in.good()) books.UpsertBook(author, title, isbn, id, cost, status, material);
+            break;
+        }
+        case Journal::BOOK_DELETE: {
+            int id = in.get<std::int32_t>();
+            if (in.good()) books.RemoveBook(id);
+            break;
+        }
+        case Journal::PATRON_PUT: {
+            int id = in.get<std::int32_t>();
+            float fine = in.get<float>();
+            int numBooks = in.get<std::int32_t>();
+            std::string name = in.getString();
+            Patron* patron = in.good() ? patrons.UpsertPatron(name, id) : nullptr;
+            if (patron) {
+                patron->setFineBalance(fine);
+                patron->setNumBooks(numBooks);
+                PatronsCollection::SetNextPatronID(std::max(PatronsCollection::GetNextPatronID(), id + 1));
+            }
+            break;
+        }
+        case Journal::PATRON_DELETE: {
+            int id = in.get<std::int32_t>();
+            if (in.good()) patrons.RemovePatron(id);
+            break;
+        }
+        case Journal::LOAN_PUT: {
+            int loanID = in.get<std::int32_t>();
+            int bookID = in.get<std::int32_t>();
+            int patronID = in.get<std::int32_t>();
+            std::int64_t due = in.get<std::int64_t>();
+            auto status = static_cast<Loans::LoanStatus>(in.get<std::uint8_t>());
+            if (in.good()) {
+                loans.UpsertLoan(loanID, bookID, patronID, due, status);
+                Loans::setNextLoanID(std::max(Loans::getNextLoanID(), loanID + 1));
+            }
+            break;
+        }
+        case Journal::LOAN_DELETE: {
+            int loanID = in.get<std::int32_t>();
+            if (in.good()) loans.RemoveLoanByID(loanID);
+            break;
+        }
+        case Journal::HOLD_PUT: {
+            Hold hold;
+            hold.holdID = in.get<std::int32_t>();
+            hold.patronID = in.get<std::int32_t>();
+            hold.isbn = in.get<std::uint64_t>();
+            hold.priority = in.get<std::uint8_t>();
+            hold.status = static_cast<Hold::HoldStatus>(in.get<std::uint8_t>());
+            hold.placedEpoch = in.get<std::int64_t>();
+            hold.bookID = in.get<std::int32_t>();
+            hold.expiresEpoch = in.get<std::int64_t>();
+            if (in.good()) loans.UpsertHold(hold);
+            break;
+        }
+        case Journal::HOLD_DELETE: {
+            int holdID = in.get<std::int32_t>();
+            if (in.good()) loans.RemoveHoldByID(holdID);
+            break;
+        }
+        case Journal::LOAN_ARCHIVED: {
+            std::uint64_t sequence = in.get<std::uint64_t>();
+            ArchivedLoan loan;
+            loan.loanID = in.get<std::int32_t>();
+            loan.bookID = in.get<std::int32_t>();
+            loan.patronID = in.get<std::int32_t>();
+            loan.dueEpoch = in.get<std::int64_t>();
+            loan.returnedEpoch = in.get<std::int64_t>();
+            loan.fineCents = in.get<std::int64_t>();
+            if (in.good()) loans.RestoreArchivedLoan(sequence, loan);
+            break;
+        }
+        default:
+            break; // unknown record types are skipped
+    }
+    return in.good();
+}
+
+} // namespace
+
+Journal::Journal() : file(nullptr), unsyncedCommits(0), fileBytes(0), stopping(false) {}
+
+Journal::~Journal() { Close(); }
+
+bool Journal::Open(const std::string& journalPath) {
+    Close();
+    std::lock_guard<std::mutex> lock(mutex);
+    path = journalPath;
+    file = std::fopen(path.c_str(), "ab");
+    if (!file) return false;
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    fileBytes = ec ? 0 : static_cast<std::uint64_t>(size);
+    stopping = false;
+    flusher = std::thread(&Journal::FlushLoop, this);
+    return true;
+}
+
+void Journal::Close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    flushWake.notify_one();
+    if (flusher.joinable()) flusher.join();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) return;
+    SyncLocked();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void Journal::Append(RecordType type, const std::string& payload) {
+    std::string body;
+    body.reserve(payload.size() + 1);
+    body.push_back(static_cast<char>(type));
+    body += payload;
+    put<std::uint32_t>(pendingRecords, static_cast<std::uint32_t>(body.size()));
+    put<std::uint32_t>(pendingRecords, Crc32(body.data(), body.size()));
+    pendingRecords += body;
+    ++pendingCount;
+}
+
+void Journal::LogBook(const Books& book) {
+    std::string payload;
+    put<std::int32_t>(payload, book.getLibraryID());
+    put<float>(payload, book.getCost());
+    put<std::uint8_t>(payload, static_cast<std::uint8_t>(book.getCurrentBookStatus()));
+    putString(payload, book.getAuthor());
+    putString(payload, book.getTitle());
+    putString(payload, book.getISBN());
+    put<std::uint8_t>(payload, static_cast<std::uint8_t>(book.getMaterial())); // absent in older journals
+    Append(BOOK_PUT, payload);
+}
+
+void Journal::LogBookDeleted(int libraryID) {
+    std::string payload;
+    put<std::int32_t>(payload, libraryID);
+    Append(BOOK_DELETE, payload);
+}
+
+void Journal::LogPatron(const Patron& patron) {
+    std::string payload;
+    put<std::int32_t>(payload, patron.getPatronID());
+    put<float>(payload, patron.getFineBalance());
+    put<std::int32_t>(payload, patron.getNumBooks());
+    putString(payload, patron.getName());
+    Append(PATRON_PUT, payload);
+}
+
+void Journal::LogPatronDeleted(int patronID) {
+    std::string payload;
+    put<std::int32_t>(payload, patronID);
+    Append(PATRON_DELETE, payload);
+}
+
+void Journal::LogLoan(const Loans& loan) {
+    std::string payload;
+    put<std::int32_t>(payload, loan.getLoanID());
+    put<std::int32_t>(payload, loan.getBookID());
+    put<std::int32_t>(payload, loan.getPatronID());
+    put<std::int64_t>(payload, loan.getDueEpoch());
+    put<std::uint8_t>(payload, static_cast<std::uint8_t>(loan.getStatus()));
+    Append(LOAN_PUT, payload);
+}
+
+void Journal::LogLoanDeleted(int loanID) {
+    std::string payload;
+    put<std::int32_t>(payload, loanID);
+    Append(LOAN_DELETE, payload);
+}
+
+void Journal::LogHold(const Hold& hold) {
+    std::string payload;
+    put<std::int32_t>(payload, hold.holdID);
+    put<std::int32_t>(payload, hold.patronID);
+    put<std::uint64_t>(payload, hold.isbn);
+    put<std::uint8_t>(payload, static_cast<std::uint8_t>(hold.priority));
+    put<std::uint8_t>(payload, static_cast<std::uint8_t>(hold.status));
+    put<std::int64_t>(payload, hold.placedEpoch);
+    put<std::int32_t>(payload, hold.bookID);
+    put<std::int64_t>(payload, hold.expiresEpoch);
+    Append(HOLD_PUT, payload);
+}
+
+void Journal::LogHoldDeleted(int holdID) {
+    std::string payload;
+    put<std::int32_t>(payload, holdID);
+    Append(HOLD_DELETE, payload);
+}
+
+void Journal::LogLoanArchived(std::uint64_t sequence, const ArchivedLoan& loan) {
+    std::string payload;
+    put<std::uint64_t>(payload, sequence);
+    put<std::int32_t>(payload, loan.loanID);
+    put<std::int32_t>(payload, loan.bookID);
+    put<std::int32_t>(payload, loan.patronID);
+    put<std::int64_t>(payload, loan.dueEpoch);
+    put<std::int64_t>(payload, loan.returnedEpoch);
+    put<std::int64_t>(payload, loan.fineCents);
+    Append(LOAN_ARCHIVED, payload);
+}
+
+void Journal::Commit() {
+    if (pendingCount > 0) {
+        std::string payload;
+        put<std::uint32_t>(payload, pendingCount);
+        Append(TRANSACTION_END, payload);
+    }
+    pendingCount = 0;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) { pendingRecords.clear(); return; }
+    if (!pendingRecords.empty()) {
+        std::fwrite(pendingRecords.data(), 1, pendingRecords.size(), file);
+        std::fflush(file);
+        fileBytes += pendingRecords.size();
+        pendingRecords.clear();
+    }
+    if (unsyncedCommits++ == 0) {
+        oldestUnsynced = std::chrono::steady_clock::now();
+        flushWake.notify_one();
+    }
+    if (unsyncedCommits >= GROUP_SIZE) SyncLocked();
+}
+
+void Journal::Sync() {
+    std::lock_guard<std::mutex> lock(mutex);
+    SyncLocked();
+}
+
+void Journal::SyncLocked() {
+    if (file) SyncFile(file);
+    unsyncedCommits = 0;
+}
+
+// Sleeps until a commit is waiting, then until GROUP_INTERVAL_MS after the oldest one
+void Journal::FlushLoop() {
+    const auto interval = std::chrono::milliseconds(GROUP_INTERVAL_MS);
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (unsyncedCommits == 0) flushWake.wait(lock);
+        else if (std::chrono::steady_clock::now() - oldestUnsynced >= interval) SyncLocked();
+        else flushWake.wait_until(lock, oldestUnsynced + interval);
+    }
+}
+
+bool Journal::Truncate() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) return false;
+    std::fclose(file);
+    file = std::fopen(path.c_str(), "wb"); // truncates
+    if (!file) return false;
+    SyncFile(file);
+    pendingRecords.clear();
+    pendingCount = 0;
+    fileBytes = 0;
+    unsyncedCommits = 0;
+    return true;
+}
+
+std::size_t Journal::Replay(const std::string& journalPath, PatronsCollection& patrons,
+                            BooksCollection& books, LoansCollection& loans) {
+    std::size_t applied = 0;
+    std::size_t validBytes = 0;
+    {
+        MappedFile mapped;
+        if (!mapped.Open(journalPath)) return 0;
+        const char* data = mapped.Data();
+        const std::size_t size = mapped.Size();
+
+        std::vector<const char*> transaction; // record bodies since the last end record
+        std::size_t pos = 0;
+        while (size - pos >= FRAME_HEADER) {
+            std::uint32_t length, crc;
+            std::memcpy(&length, data + pos, sizeof(length));
+            std::memcpy(&crc, data + pos + 4, sizeof(crc));
+            if (length == 0 || length > size - pos - FRAME_HEADER) break; // torn write
+            const char* body = data + pos + FRAME_HEADER;
+            if (Crc32(body, length) != crc) break;
+            pos += FRAME_HEADER + length;
+
+            // A transaction is applied once its end record is read; a torn one is dropped whole
+            if (static_cast<RecordType>(body[0]) != TRANSACTION_END) {
+                transaction.push_back(body);
+                continue;
+            }
+            PayloadReader in(body + 1, length - 1);
+            const std::uint32_t count = in.get<std::uint32_t>();
+            if (!in.good() || count != transaction.size()) break;
+            for (const char* record : transaction) {
+                std::uint32_t recordLength;
+                std::memcpy(&recordLength, record - FRAME_HEADER, sizeof(recordLength));
+                if (applyRecord(record, recordLength, patrons, books, loans)) ++applied;
+            }
+            transaction.clear();
+            validBytes = pos;
+        }
+        if (validBytes == size) {
+            if (applied > 0) loans.RecomputeOverdueStatus();
+            return applied;
+        }
+    } // unmap before resizing the file
+
+    std::error_code ec;
+    std::filesystem::resize_file(journalPath, validBytes, ec);
+    if (applied > 0) loans.RecomputeOverdueStatus();
+    return applied;
+}
@@ -0,0 +1,109 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "Books.h"
+#include "Patron.h"
+#include "Loans.h"
+#include "HoldQueues.h"
+#include "LoanArchive.h"
+
+class PatronsCollection;
+class BooksCollection;
+class LoansCollection;
+
+// Append-only write-ahead log of collection mutations, replayed on top of the last snapshot.
+//
+// Every record stores the full new state of one book, patron, loan or hold (or its deletion),
+// or a returned loan with its archive sequence number, so replaying a record twice is
+// harmless. Records are framed as [payload length][CRC-32][type][payload], and every
+// transaction ends with a TRANSACTION_END record. Replay applies a transaction only once its
+// end record is read, and stops at the first torn or corrupt record, so a crash mid-write
+// never leaves half a checkout applied.
+// Log* calls only append to a buffer private to the calling thread. Commit() hands that
+// thread's records to the OS in one write, so concurrent transactions never interleave in
+// the file. A full group of transactions is fsynced by the commit that completes it, and a
+// flusher thread fsyncs any smaller group once its oldest transaction has waited the interval.
+// Callers commit while still holding the record locks of what they logged, so records
+// for the same book or patron reach the file in the order the changes were made.
+class Journal {
+public:
+    enum RecordType : std::uint8_t {
+        BOOK_PUT = 1,
+        BOOK_DELETE = 2,
+        PATRON_PUT = 3,
+        PATRON_DELETE = 4,
+        LOAN_PUT = 5,
+        LOAN_DELETE = 6,
+        HOLD_PUT = 7,
+        HOLD_DELETE = 8,
+        LOAN_ARCHIVED = 9,
+        TRANSACTION_END = 10 // closes each Commit; payload is the transaction's record count
+    };
+
+    // Transactions per fsync, and the longest a committed transaction waits for one
+    static constexpr int GROUP_SIZE = 64;
+    static constexpr int GROUP_INTERVAL_MS = 200;
+
+    Journal();
+    ~Journal();
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Opens the journal for appending (creating it if needed)
+    bool Open(const std::string& path);
+    void Close();
+
+    void LogBook(const Books& book);
+    void LogBookDeleted(int libraryID);
+    void LogPatron(const Patron& patron);
+    void LogPatronDeleted(int patronID);
+    void LogLoan(const Loans& loan);
+    void LogLoanDeleted(int loanID);
+    void LogHold(const Hold& hold);
+    void LogHoldDeleted(int holdID);
+    void LogLoanArchived(std::uint64_t sequence, const ArchivedLoan& loan);
+
+    // Ends the calling thread's transaction: writes its records and fsyncs per the group policy
+    void Commit();
+
+    // Fsyncs everything committed so far
+    void Sync();
+
+    // Empties the journal; call once its contents are folded into a snapshot
+    bool Truncate();
+
+    // Bytes written to the journal file so far
+    std::uint64_t SizeBytes() const { return fileBytes; }
+
+    // Applies the complete transactions in a journal file to the collections; returns the
+    // number of records applied. Everything after the last complete transaction is cut off
+    // so later appends start from a clean transaction boundary.
+    static std::size_t Replay(const std::string& path, PatronsCollection& patrons,
+                              BooksCollection& books, LoansCollection& loans);
+
+private:
+    void Append(RecordType type, const std::string& payload);
+    void SyncLocked();
+    void FlushLoop(); // flusher thread body
+
+    std::mutex mutex;         // serializes commits and the file handle
+    std::FILE* file;
+    std::string path;
+    int unsyncedCommits;      // transactions written since the last fsync
+    std::atomic<std::uint64_t> fileBytes;
+    std::chrono::steady_clock::time_point oldestUnsynced; // commit time of the first of them
+    std::condition_variable flushWake;
+    std::thread flusher;
+    bool stopping;
+};
+
+#endif // JOURNAL_H
@@ -0,0 +1,177 @@
+#include "LibraryCalendar.h"
+#include <algorithm>
+#include <bit>
+#include <ctime>
+
+// helpers (file-local)
+namespace {
+
+const int FIRST_YEAR = 1970; // day 0
+const int END_YEAR = 2200;   // first year past the bitmap
+
+} // namespace
+
+LibraryCalendar::LibraryCalendar() : weeklyClosed(1), days(0) { // closed on Sundays
+    holidays = { { 1, 1 }, { 7, 4 }, { 12, 25 } };
+    holidayRules = { { 11, 4, 4 } }; // Thanksgiving
+    Rebuild();
+}
+
+// Days-from-civil and civil-from-days after Howard Hinnant's public-domain algorithms
+std::int64_t LibraryCalendar::DayNumber(int year, int month, int day) {
+    const std::int64_t y = year - (month <= 2 ? 1 : 0);
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const std::int64_t yearOfEra = y - era * 400;
+    const std::int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const std::int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+void LibraryCalendar::CivilDate(std::int64_t dayNumber, int& year, int& month, int& day) {
+    const std::int64_t z = dayNumber + 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const std::int64_t dayOfEra = z - era * 146097;
+    const std::int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const std::int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const std::int64_t mp = (5 * dayOfYear + 2) / 153;
+    day = static_cast<int>(dayOfYear - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+int LibraryCalendar::Weekday(std::int64_t dayNumber) {
+    const std::int64_t w = (dayNumber + 4) % 7; // 1970-01-01 was a Thursday
+    return static_cast<int>(w < 0 ? w + 7 : w);
+}
+
+std::int64_t LibraryCalendar::LocalDay(std::int64_t epoch) {
+    std::time_t t = static_cast<std::time_t>(epoch);
+    std::tm tm;
+#if defined(_MSC_VER)
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    return DayNumber(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+}
+
+std::int64_t LibraryCalendar::LocalStartOfDay(std::int64_t dayNumber) {
+    std::tm tm{};
+    CivilDate(dayNumber, tm.tm_year, tm.tm_mon, tm.tm_mday);
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    tm.tm_isdst = -1;
+    return static_cast<std::int64_t>(std::mktime(&tm));
+}
+
+void LibraryCalendar::SetWeeklyClosed(int weekday, bool closed) {
+    if (weekday < 0 || weekday > 6) return;
+    if (closed) weeklyClosed |= static_cast<std::uint8_t>(1u << weekday);
+    else weeklyClosed &= static_cast<std::uint8_t>(~(1u << weekday));
+    Rebuild();
+}
+
+void LibraryCalendar::AddHoliday(int month, int day) {
+    holidays.emplace_back(month, day);
+    Rebuild();
+}
+
+void LibraryCalendar::AddHolidayRule(int month, int weekday, int nth) {
+    holidayRules.push_back({ month, weekday, nth });
+    Rebuild();
+}
+
+void LibraryCalendar::AddClosure(std::int64_t dayNumber) {
+    closures.push_back(dayNumber);
+    Rebuild();
+}
+
+void LibraryCalendar::ClearClosures() {
+    weeklyClosed = 0;
+    holidays.clear();
+    holidayRules.clear();
+    closures.clear();
+    Rebuild();
+}
+
+bool LibraryCalendar::ClosedByRule(std::int64_t dayNumber) const {
+    if (weeklyClosed & (1u << Weekday(dayNumber))) return true;
+    int year, month, day;
+    CivilDate(dayNumber, year, month, day);
+    for (const auto& holiday : holidays) {
+        if (holiday.first == month && holiday.second == day) return true;
+    }
+    for (const HolidayRule& rule : holidayRules) {
+        if (rule.month == month && rule.weekday == Weekday(dayNumber) && (day - 1) / 7 + 1 == rule.nth) return true;
+    }
+    return std::find(closures.begin(), closures.end(), dayNumber) != closures.end();
+}
+
+void LibraryCalendar::Rebuild() {
+    days = DayNumber(END_YEAR, 1, 1);
+    const std::size_t words = static_cast<std::size_t>((days + 63) / 64);
+    open.assign(words, ~std::uint64_t(0));
+    if (days % 64 != 0) open.back() = (std::uint64_t(1) << (days % 64)) - 1;
+    auto close = [this](std::int64_t d) {
+        if (d >= 0 && d < days) open[d / 64] &= ~(std::uint64_t(1) << (d % 64));
+    };
+
+    for (int weekday = 0; weekday < 7; ++weekday) {
+        if (!(weeklyClosed & (1u << weekday))) continue;
+        for (std::int64_t d = (weekday - Weekday(0) + 7) % 7; d < days; d += 7) close(d);
+    }
+    for (int year = FIRST_YEAR; year < END_YEAR; ++year) {
+        for (const auto& holiday : holidays) close(DayNumber(year, holiday.first, holiday.second));
+        for (const HolidayRule& rule : holidayRules) {
+            const std::int64_t first = DayNumber(year, rule.month, 1);
+            const std::int64_t day = first + (rule.weekday - Weekday(first) + 7) % 7 + 7 * (rule.nth - 1);
+            if (day < DayNumber(year + rule.month / 12, rule.month % 12 + 1, 1)) close(day); // no 5th one some months
+        }
+    }
+    for (std::int64_t d : closures) close(d);
+
+    openBeforeWord.assign(words + 1, 0);
+    for (std::size_t w = 0; w < words; ++w) openBeforeWord[w + 1] = openBeforeWord[w] + std::popcount(open[w]);
+    nextOpenWord.assign(words + 1, static_cast<std::uint32_t>(words));
+    for (std::size_t w = words; w-- > 0;) nextOpenWord[w] = open[w] ? static_cast<std::uint32_t>(w) : nextOpenWord[w + 1];
+}
+
+bool LibraryCalendar::IsOpen(std::int64_t dayNumber) const {
+    if (dayNumber < 0 || dayNumber >= days) return !ClosedByRule(dayNumber);
+    return (open[dayNumber / 64] >> (dayNumber % 64)) & 1;
+}
+
+std::int64_t LibraryCalendar::NextOpenDay(std::int64_t dayNumber) const {
+    if (dayNumber >= 0 && dayNumber < days) {
+        const std::size_t w = static_cast<std::size_t>(dayNumber / 64);
+        const std::uint64_t rest = open[w] >> (dayNumber % 64);
+        if (rest) return dayNumber + std::countr_zero(rest);
+        const std::uint32_t next = nextOpenWord[w + 1];
+        if (next < open.size()) return static_cast<std::int64_t>(next) * 64 + std::countr_zero(open[next]);
+        dayNumber = days;
+    }
+    // Outside the bitmap: walk the rules (a year at most, unless nothing is ever open)
+    for (std::int64_t d = dayNumber; d < dayNumber + 366; ++d) {
+        if (!ClosedByRule(d)) return d;
+    }
+    return dayNumber;
+}
+
+std::int64_t LibraryCalendar::OpenBefore(std::int64_t dayNumber) const {
+    const std::size_t w = static_cast<std::size_t>(dayNumber / 64);
+    const int bit = static_cast<int>(dayNumber % 64);
+    std::int64_t count = openBeforeWord[w];
+    if (bit != 0) count += std::popcount(open[w] & ((std::uint64_t(1) << bit) - 1));
+    return count;
+}
+
+std::int64_t LibraryCalendar::OpenDaysAfter(std::int64_t from, std::int64_t to) const {
+    if (to <= from) return 0;
+    const std::int64_t lo = std::clamp<std::int64_t>(from + 1, 0, days);
+    const std::int64_t hi = std::clamp<std::int64_t>(to + 1, 0, days);
+    std::int64_t count = OpenBefore(hi) - OpenBefore(lo);
+    // Parts outside the bitmap, day by day
+    for (std::int64_t d = from + 1; d <= to && d < 0; ++d) count += ClosedByRule(d) ? 0 : 1;
+    for (std::int64_t d = std::max(from + 1, days); d <= to; ++d) count += ClosedByRule(d) ? 0 : 1;
+    return count;
+}
@@ -0,0 +1,68 @@
+#ifndef LIBRARYCALENDAR_H
+#define LIBRARYCALENDAR_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Which days the library is open, for due dates and fines.
+//
+// Days are numbered from 1970-01-01 (day 0) in the local civil calendar and converted with
+// plain arithmetic; only LocalDay/LocalStartOfDay go through the C time zone functions.
+// Opening days from 1970 through 2199 are precomputed into a bitmap (one bit per day,
+// about 10 KB) with two small side tables: open days before each 64-day word, and the
+// first word at or after each word that has an open day. That makes "next open day on or
+// after d" and "open days between a and b" O(1) bit operations.
+//
+// Closed days come from weekly closures, annual holidays (fixed dates and "nth weekday of
+// a month" rules) and one-off closures. The default calendar closes on Sundays, New Year's
+// Day, Independence Day, Thanksgiving and Christmas. Changing the rules rebuilds the
+// bitmap. Queries are read-only and may run concurrently; changes may not.
+class LibraryCalendar {
+public:
+    LibraryCalendar();
+
+    // Day number conversions (proleptic Gregorian); weekday 0 is Sunday
+    static std::int64_t DayNumber(int year, int month, int day);
+    static void CivilDate(std::int64_t dayNumber, int& year, int& month, int& day);
+    static int Weekday(std::int64_t dayNumber);
+
+    // Local calendar day of an instant, and the instant a local day starts
+    static std::int64_t LocalDay(std::int64_t epoch);
+    static std::int64_t LocalStartOfDay(std::int64_t dayNumber);
+
+    // Closure rules; each change rebuilds the bitmap
+    void SetWeeklyClosed(int weekday, bool closed);
+    void AddHoliday(int month, int day);                    // every year on this date
+    void AddHolidayRule(int month, int weekday, int nth);   // e.g. 4th Thursday of November
+    void AddClosure(std::int64_t dayNumber);                // one day only
+    void ClearClosures();                                   // open every day
+
+    bool IsOpen(std::int64_t dayNumber) const;
+
+    // First open day on or after dayNumber (dayNumber itself if no day is ever open)
+    std::int64_t NextOpenDay(std::int64_t dayNumber) const;
+
+    // Open days d with from < d <= to (0 if to <= from)
+    std::int64_t OpenDaysAfter(std::int64_t from, std::int64_t to) const;
+
+private:
+    void Rebuild();
+    bool ClosedByRule(std::int64_t dayNumber) const; // for days outside the bitmap
+
+    // Open days in [0, dayNumber) of the bitmap range
+    std::int64_t OpenBefore(std::int64_t dayNumber) const;
+
+    std::uint8_t weeklyClosed; // bit w set: closed on weekday w
+    std::vector<std::pair<int, int>> holidays;   // (month, day)
+    struct HolidayRule { int month, weekday, nth; };
+    std::vector<HolidayRule> holidayRules;
+    std::vector<std::int64_t> closures;
+
+    std::int64_t days;                  // days covered by the bitmap, from day 0
+    std::vector<std::uint64_t> open;    // bit d % 64 of word d / 64: day d is open
+    std::vector<std::int64_t> openBeforeWord;
+    std::vector<std::uint32_t> nextOpenWord; // first word >= w with an open day, or open.size()
+};
+
+#endif // LIBRARYCALENDAR_H
@@ -0,0 +1,138 @@
+#include "LibraryConfig.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+// helpers (file-local)
+namespace {
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+    return s;
+}
+
+bool parseCount(std::string_view s, std::int64_t& value) {
+    auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+    return result.ec == std::errc() && result.ptr == s.data() + s.size() && value >= 0;
+}
+
+// Splits "a-b-c" into exactly count numbers or weekday names (sun..sat give 0..6)
+bool parseParts(std::string_view s, int count, int* parts) {
+    static const char* const WEEKDAYS[7] = { "sun", "mon", "tue", "wed", "thu", "fri", "sat" };
+    for (int i = 0; i < count; ++i) {
+        const std::size_t dash = i + 1 < count ? s.find('-') : s.size();
+        if (dash == std::string_view::npos) return false;
+        const std::string_view part = s.substr(0, dash);
+        s.remove_prefix(std::min(dash + 1, s.size()));
+        std::int64_t number;
+        if (parseCount(part, number) && number <= 9999) {
+            parts[i] = static_cast<int>(number);
+            continue;
+        }
+        const auto* name = std::find(WEEKDAYS, WEEKDAYS + 7, part);
+        if (name == WEEKDAYS + 7) return false;
+        parts[i] = static_cast<int>(name - WEEKDAYS);
+    }
+    return true;
+}
+
+bool validMonthDay(int month, int day) {
+    return month >= 1 && month <= 12 && day >= 1 && day <= 31;
+}
+
+// Calls fn on each trimmed, non-empty item of a comma-separated list
+template <typename Fn>
+void forEachItem(std::string_view list, Fn fn) {
+    while (!list.empty()) {
+        const std::size_t comma = std::min(list.find(','), list.size());
+        const std::string_view item = trim(list.substr(0, comma));
+        if (!item.empty()) fn(item);
+        list.remove_prefix(std::min(comma + 1, list.size()));
+    }
+}
+
+} // namespace
+
+bool LibraryConfig::Load(const std::string& path, LoansCollection& loans, std::vector<std::string>& problems) {
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) return !ec;
+    std::ifstream in(path);
+    if (!in) return false;
+
+    FinePolicy fines;
+    LibraryCalendar calendar;
+    bool calendarGiven = false;
+    std::string text;
+    for (int lineNumber = 1; std::getline(in, text); ++lineNumber) {
+        std::string_view line = text;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+        const std::size_t equals = line.find('=');
+        const std::string_view key = trim(line.substr(0, equals));
+        const std::string_view value = equals == std::string_view::npos ? std::string_view()
+                                                                        : trim(line.substr(equals + 1));
+        const std::string where = "line " + std::to_string(lineNumber) + ": ";
+
+        std::int64_t number = 0;
+        auto badItem = [&](std::string_view item) {
+            problems.push_back(where + std::string(key) + " cannot use \"" + std::string(item) + "\"");
+        };
+        if (key == "fine_cents_per_day" || key == "fine_cap_cents") {
+            if (!parseCount(value, number)) {
+                problems.push_back(where + std::string(key) + " needs a whole number of cents");
+                continue;
+            }
+            if (key == "fine_cents_per_day") fines.centsPerDay = number;
+            else fines.maxCentsPerLoan = number;
+        } else if (key == "loan_days_book" || key == "loan_days_dvd" || key == "loan_days_magazine"
+                   || key == "loan_days_audiobook" || key == "pickup_days") {
+            if (!parseCount(value, number) || number > 3650) {
+                problems.push_back(where + std::string(key) + " needs a number of days");
+                continue;
+            }
+            const int days = static_cast<int>(number);
+            if (key == "loan_days_book") loans.SetLoanDays(Books::BOOK, days);
+            else if (key == "loan_days_dvd") loans.SetLoanDays(Books::DVD, days);
+            else if (key == "loan_days_magazine") loans.SetLoanDays(Books::MAGAZINE, days);
+            else if (key == "loan_days_audiobook") loans.SetLoanDays(Books::AUDIOBOOK, days);
+            else loans.SetPickupDays(days);
+        } else if (key == "closed_weekdays" || key == "holidays" || key == "holiday_rules" || key == "closures") {
+            if (!calendarGiven) calendar.ClearClosures();
+            calendarGiven = true;
+            forEachItem(value, [&](std::string_view item) {
+                int parts[3];
+                if (key == "closed_weekdays") {
+                    if (parseParts(item, 1, parts) && parts[0] <= 6) calendar.SetWeeklyClosed(parts[0], true);
+                    else badItem(item);
+                } else if (key == "holidays") {
+                    if (parseParts(item, 2, parts) && validMonthDay(parts[0], parts[1])) {
+                        calendar.AddHoliday(parts[0], parts[1]);
+                    } else {
+                        badItem(item);
+                    }
+                } else if (key == "holiday_rules") {
+                    if (parseParts(item, 3, parts) && validMonthDay(parts[0], 1) && parts[1] <= 6
+                        && parts[2] >= 1 && parts[2] <= 5) {
+                        calendar.AddHolidayRule(parts[0], parts[1], parts[2]);
+                    } else {
+                        badItem(item);
+                    }
+                } else if (parseParts(item, 3, parts) && validMonthDay(parts[1], parts[2])) {
+                    calendar.AddClosure(LibraryCalendar::DayNumber(parts[0], parts[1], parts[2]));
+                } else {
+                    badItem(item);
+                }
+            });
+        } else {
+            problems.push_back(where + "unknown setting \"" + std::string(key) + "\"");
+        }
+    }
+    loans.SetFinePolicy(fines);
+    if (calendarGiven) loans.SetCalendar(calendar);
+    return true;
+}
@@ -0,0 +1,31 @@
+#ifndef LIBRARYCONFIG_H
+#define LIBRARYCONFIG_H
+
+#include <string>
+#include <vector>
+#include "LoansCollection.h"
+
+// Circulation settings kept in a plain text file next to the library data and read at
+// every start, before any loan is loaded, so that fines are rebuilt with the same policy
+// and calendar they accrued under. One "key = value" per line; '#' starts a comment. Keys:
+//   fine_cents_per_day   late fee per open day after the due date (default 25)
+//   fine_cap_cents       most a single loan can be fined (default 1000)
+//   loan_days_book, loan_days_dvd, loan_days_magazine, loan_days_audiobook
+//                        loan period per material, in days (defaults 7, 3, 7, 14)
+//   pickup_days          open days a copy set aside for a hold waits (default 3)
+//   closed_weekdays      e.g. "sun, sat"; empty for none
+//   holidays             closed every year, as MM-DD, e.g. "01-01, 12-25"
+//   holiday_rules        closed every year, as month-weekday-nth, e.g. "11-thu-4"
+//   closures             closed once, as YYYY-MM-DD
+// A key that is absent keeps its default. The calendar keys replace the default calendar
+// (Sundays, New Year's Day, Independence Day, Thanksgiving, Christmas) as a whole: once
+// one is given, only the closures listed are kept. Lists are comma-separated.
+class LibraryConfig {
+public:
+    // Applies the settings in path to loans. A missing file leaves every default in place;
+    // lines that cannot be used are skipped and described in problems. Returns false only
+    // if the file exists but cannot be read.
+    static bool Load(const std::string& path, LoansCollection& loans, std::vector<std::string>& problems);
+};
+
+#endif // LIBRARYCONFIG_H
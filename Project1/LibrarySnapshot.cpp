@@ -0,0 +1,287 @@
+#include "LibrarySnapshot.h"
+#include "MappedFile.h"
+#include "FileSync.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// On-disk structures. The file is written in host byte order (little-endian on
+// every platform this project targets); the version field guards layout changes.
+namespace {
+
+const char MAGIC[8] = { 'L', 'I', 'B', 'S', 'N', 'A', 'P', '\0' };
+
+struct StringRef {
+    std::uint32_t offset;
+    std::uint32_t length;
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::int32_t nextPatronID;
+    std::int32_t nextLoanID;
+    std::uint64_t booksOffset;
+    std::uint64_t bookCount;
+    std::uint64_t patronsOffset;
+    std::uint64_t patronCount;
+    std::uint64_t loansOffset;
+    std::uint64_t loanCount;
+    std::uint64_t holdsOffset;
+    std::uint64_t holdCount;
+    std::int32_t nextHoldID;
+    std::uint32_t reserved;
+    std::uint64_t stringsOffset;
+    std::uint64_t stringsSize;
+};
+
+struct BookRecord {
+    StringRef author;
+    StringRef title;
+    StringRef isbn;
+    StringRef titleKey; // prebuilt BooksCollection::NormalizeTitle(title)
+    std::int32_t libraryID;
+    float cost;
+    std::uint32_t status;
+    std::uint32_t material;
+};
+
+struct PatronRecord {
+    StringRef name;
+    std::int32_t patronID;
+    float fineBalance;
+    std::int32_t numBooks;
+};
+
+struct LoanRecord {
+    std::int64_t dueEpoch;
+    std::int32_t loanID;
+    std::int32_t bookID;
+    std::int32_t patronID;
+    std::uint32_t status;
+};
+
+struct HoldRecord {
+    std::uint64_t isbn; // packed
+    std::int64_t placedEpoch;
+    std::int64_t expiresEpoch;
+    std::int32_t holdID;
+    std::int32_t patronID;
+    std::int32_t bookID;
+    std::uint16_t priority;
+    std::uint16_t status;
+};
+
+static_assert(sizeof(SnapshotHeader) == 112, "snapshot header layout changed; bump VERSION");
+static_assert(sizeof(BookRecord) == 48, "book record layout changed; bump VERSION");
+static_assert(sizeof(PatronRecord) == 20, "patron record layout changed; bump VERSION");
+static_assert(sizeof(LoanRecord) == 24, "loan record layout changed; bump VERSION");
+static_assert(sizeof(HoldRecord) == 40, "hold record layout changed; bump VERSION");
+
+// Builds the shared string pool, storing each distinct string once
+class StringPoolWriter {
+public:
+    StringRef Add(std::string_view s) {
+        auto it = seen.find(s);
+        if (it != seen.end()) return it->second;
+        StringRef ref{ static_cast<std::uint32_t>(bytes.size()), static_cast<std::uint32_t>(s.size()) };
+        bytes += s;
+        seen.emplace(s, ref);
+        return ref;
+    }
+    const std::string& Bytes() const { return bytes; }
+
+private:
+    std::string bytes;
+    // Transparent hash so lookups by string_view do not build a std::string
+    struct Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+    };
+    std::unordered_map<std::string, StringRef, Hash, std::equal_to<>> seen;
+};
+
+template <typename T>
+void writeRaw(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// True if [offset, offset + count * recordSize) lies inside a file of fileSize bytes
+bool sectionFits(std::uint64_t offset, std::uint64_t count, std::size_t recordSize, std::size_t fileSize) {
+    if (offset > fileSize) return false;
+    return count <= (fileSize - offset) / recordSize;
+}
+
+} // namespace
+
+bool LibrarySnapshot::Save(const std::string& path, const PatronsCollection& patrons,
+                           const BooksCollection& books, const LoansCollection& loans) {
+    const std::string tmpPath = path + ".tmp";
+    std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.nextPatronID = PatronsCollection::GetNextPatronID();
+    header.nextLoanID = Loans::getNextLoanID();
+    header.nextHoldID = loans.GetNextHoldID();
+    writeRaw(out, header); // placeholder, rewritten once the offsets are known
+
+    StringPoolWriter pool;
+
+    header.booksOffset = static_cast<std::uint64_t>(out.tellp());
+    books.ForEachBook([&](const Books& book) {
+        BookRecord rec{};
+        rec.author = pool.Add(book.getAuthor());
+        rec.title = pool.Add(book.getTitle());
+        rec.isbn = pool.Add(book.getISBN());
+        rec.titleKey = pool.Add(BooksCollection::NormalizeTitle(book.getTitle()));
+        rec.libraryID = book.getLibraryID();
+        rec.cost = book.getCost();
+        rec.status = static_cast<std::uint32_t>(book.getCurrentBookStatus());
+        rec.material = static_cast<std::uint32_t>(book.getMaterial());
+        writeRaw(out, rec);
+        ++header.bookCount;
+    });
+
+    header.patronsOffset = static_cast<std::uint64_t>(out.tellp());
+    patrons.ForEachPatron([&](const Patron& patron) {
+        PatronRecord rec{};
+        rec.name = pool.Add(patron.getName());
+        rec.patronID = patron.getPatronID();
+        rec.fineBalance = patron.getFineBalance();
+        rec.numBooks = patron.getNumBooks();
+        writeRaw(out, rec);
+        ++header.patronCount;
+    });
+
+    header.loansOffset = static_cast<std::uint64_t>(out.tellp());
+    loans.ForEachLoan([&](const Loans& loan) {
+        LoanRecord rec{};
+        rec.dueEpoch = loan.getDueEpoch();
+        rec.loanID = loan.getLoanID();
+        rec.bookID = loan.getBookID();
+        rec.patronID = loan.getPatronID();
+        rec.status = static_cast<std::uint32_t>(loan.getStatus());
+        writeRaw(out, rec);
+        ++header.loanCount;
+    });
+
+    header.holdsOffset = static_cast<std::uint64_t>(out.tellp());
+    loans.ForEachHold([&](const Hold& hold) {
+        HoldRecord rec{};
+        rec.isbn = hold.isbn;
+        rec.placedEpoch = hold.placedEpoch;
+        rec.expiresEpoch = hold.expiresEpoch;
+        rec.holdID = hold.holdID;
+        rec.patronID = hold.patronID;
+        rec.bookID = hold.bookID;
+        rec.priority = static_cast<std::uint16_t>(hold.priority);
+        rec.status = static_cast<std::uint16_t>(hold.status);
+        writeRaw(out, rec);
+        ++header.holdCount;
+    });
+
+    header.stringsOffset = static_cast<std::uint64_t>(out.tellp());
+    header.stringsSize = pool.Bytes().size();
+    out.write(pool.Bytes().data(), static_cast<std::streamsize>(pool.Bytes().size()));
+
+    out.seekp(0);
+    writeRaw(out, header);
+    out.close();
+    if (!out) return false;
+    return DurableRename(tmpPath, path);
+}
+
+LibrarySnapshot::LoadResult LibrarySnapshot::Load(const std::string& path, PatronsCollection& patrons,
+                                                  BooksCollection& books, LoansCollection& loans) {
+    std::error_code ec;
+    if (!std::filesystem::exists(path, ec)) return ec ? UNREADABLE : NO_FILE;
+    MappedFile file;
+    if (!file.Open(path) || file.Size() < sizeof(SnapshotHeader)) return UNREADABLE;
+    const char* base = file.Data();
+    const std::size_t size = file.Size();
+
+    SnapshotHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION
+        || header.headerSize != sizeof(SnapshotHeader)) {
+        return UNREADABLE;
+    }
+    if (!sectionFits(header.booksOffset, header.bookCount, sizeof(BookRecord), size)
+        || !sectionFits(header.patronsOffset, header.patronCount, sizeof(PatronRecord), size)
+        || !sectionFits(header.loansOffset, header.loanCount, sizeof(LoanRecord), size)
+        || !sectionFits(header.holdsOffset, header.holdCount, sizeof(HoldRecord), size)
+        || !sectionFits(header.stringsOffset, header.stringsSize, 1, size)) {
+        return UNREADABLE;
+    }
+
+    const char* strings = base + header.stringsOffset;
+    auto str = [&](const StringRef& ref) {
+        if (ref.offset > header.stringsSize || ref.length > header.stringsSize - ref.offset) return std::string();
+        return std::string(strings + ref.offset, ref.length);
+    };
+
+    // Snapshot library IDs are distinct, so the books go in as one bulk load
+    std::vector<Books> loadedBooks;
+    std::vector<std::string> titleKeys;
+    loadedBooks.reserve(static_cast<std::size_t>(header.bookCount));
+    titleKeys.reserve(static_cast<std::size_t>(header.bookCount));
+    for (std::uint64_t i = 0; i < header.bookCount; ++i) {
+        BookRecord rec;
+        std::memcpy(&rec, base + header.booksOffset + i * sizeof(BookRecord), sizeof(rec));
+        loadedBooks.emplace_back(str(rec.author), str(rec.title), str(rec.isbn), rec.libraryID, rec.cost,
+                                 static_cast<Books::BookStatus>(rec.status), static_cast<Books::Material>(rec.material));
+        titleKeys.push_back(str(rec.titleKey));
+    }
+    books.InsertBooksBulk(loadedBooks, titleKeys);
+
+    std::vector<Patron> loadedPatrons;
+    loadedPatrons.reserve(static_cast<std::size_t>(header.patronCount));
+    for (std::uint64_t i = 0; i < header.patronCount; ++i) {
+        PatronRecord rec;
+        std::memcpy(&rec, base + header.patronsOffset + i * sizeof(PatronRecord), sizeof(rec));
+        Patron& patron = loadedPatrons.emplace_back(str(rec.name), rec.patronID);
+        patron.setFineBalance(rec.fineBalance);
+        patron.setNumBooks(rec.numBooks);
+    }
+    patrons.InsertPatronsBulk(loadedPatrons);
+
+    loans.Reserve(static_cast<std::size_t>(header.loanCount));
+    for (std::uint64_t i = 0; i < header.loanCount; ++i) {
+        LoanRecord rec;
+        std::memcpy(&rec, base + header.loansOffset + i * sizeof(LoanRecord), sizeof(rec));
+        loans.InsertLoan(rec.loanID, rec.bookID, rec.patronID, rec.dueEpoch, static_cast<Loans::LoanStatus>(rec.status));
+    }
+
+    // Saved in serving order, so inserting them in file order rebuilds every queue
+    for (std::uint64_t i = 0; i < header.holdCount; ++i) {
+        HoldRecord rec;
+        std::memcpy(&rec, base + header.holdsOffset + i * sizeof(HoldRecord), sizeof(rec));
+        Hold hold;
+        hold.holdID = rec.holdID;
+        hold.patronID = rec.patronID;
+        hold.isbn = rec.isbn;
+        hold.priority = rec.priority;
+        hold.status = static_cast<Hold::HoldStatus>(rec.status);
+        hold.placedEpoch = rec.placedEpoch;
+        hold.bookID = rec.bookID;
+        hold.expiresEpoch = rec.expiresEpoch;
+        loans.UpsertHold(hold);
+    }
+
+    PatronsCollection::SetNextPatronID(header.nextPatronID);
+    Loans::setNextLoanID(header.nextLoanID);
+    loans.SetNextHoldID(std::max(header.nextHoldID, loans.GetNextHoldID()));
+    loans.RecomputeOverdueStatus();
+    return LOADED;
+}
@@ -0,0 +1,37 @@
+#ifndef LIBRARYSNAPSHOT_H
+#define LIBRARYSNAPSHOT_H
+
+#include <string>
+#include "PatronsCollection.h"
+#include "BooksCollection.h"
+#include "LoansCollection.h"
+
+// Versioned binary snapshot of all three collections.
+//
+// Layout: a fixed header, then fixed-width record tables for books, patrons, loans
+// and holds (each title's queue in serving order), then one shared string pool.
+// Records refer to strings by (offset, length) into the pool; repeated strings such
+// as authors are stored once. Each book record also carries its prebuilt title-index
+// key. Load maps the file and reads the tables in place, so there is no per-field
+// parsing.
+class LibrarySnapshot {
+public:
+    static const unsigned int VERSION = 3;
+
+    // Writes the collections to path (via a temporary file that is fsynced and then renamed
+    // over it, so the old snapshot survives until the new one is on disk)
+    static bool Save(const std::string& path, const PatronsCollection& patrons,
+                     const BooksCollection& books, const LoansCollection& loans);
+
+    enum LoadResult {
+        LOADED,
+        NO_FILE,    // nothing saved yet
+        UNREADABLE  // truncated, damaged or from another format version; nothing was loaded
+    };
+
+    // Loads a snapshot into empty collections
+    static LoadResult Load(const std::string& path, PatronsCollection& patrons,
+                           BooksCollection& books, LoansCollection& loans);
+};
+
+#endif // LIBRARYSNAPSHOT_H
@@ -0,0 +1,353 @@
+#include "LoanArchive.h"
+#include "Checksum.h"
+#include "FileSync.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+// helpers (file-local)
+namespace {
+
+const char BLOCK_MAGIC[4] = { 'L', 'A', 'R', 'C' };
+const char TAIL_MAGIC[4] = { 'L', 'A', 'R', 'T' };
+
+// Tail file header; the payload after it is encoded like a block's, empty slots included
+struct TailHeader {
+    char magic[4];
+    std::uint32_t count;
+    std::uint32_t payloadBytes;
+    std::uint32_t crc;        // of the payload
+    std::uint64_t firstSequence;
+};
+static_assert(sizeof(TailHeader) == 24, "archive tail header layout changed");
+
+std::uint64_t zigzag(std::int64_t v) {
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t v) {
+    return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+void putVarint(std::string& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+// Bounds-checked varint reader over one block payload
+class VarintReader {
+public:
+    VarintReader(const char* data, std::size_t size) : data(data), size(size), pos(0), ok(true) {}
+
+    std::uint64_t Next() {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos == size) break;
+            const unsigned char byte = static_cast<unsigned char>(data[pos++]);
+            v |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+
+    std::int64_t NextSigned() { return unzigzag(Next()); }
+    bool good() const { return ok; }
+    bool atEnd() const { return pos == size; }
+
+private:
+    const char* data;
+    std::size_t size;
+    std::size_t pos;
+    bool ok;
+};
+
+} // namespace
+
+LoanArchive::LoanArchive() : file(nullptr), fileBytes(0), sealedLoans(0) {}
+
+LoanArchive::~LoanArchive() { Close(); }
+
+bool LoanArchive::Open(const std::string& archivePath) {
+    Close();
+    std::lock_guard<std::mutex> lock(mutex);
+    path = archivePath;
+    blocks.clear();
+    sealedLoans = 0;
+    pending.clear();
+
+    // Read the block headers; stop at the first one that is cut short or damaged
+    std::uint64_t validBytes = 0;
+    std::uint64_t size = 0;
+    {
+        MappedFile mapped;
+        if (mapped.Open(path)) {
+            const char* data = mapped.Data();
+            size = mapped.Size();
+            std::uint64_t pos = 0;
+            while (size - pos >= sizeof(BlockHeader)) {
+                Block block;
+                std::memcpy(&block.header, data + pos, sizeof(BlockHeader));
+                block.offset = pos + sizeof(BlockHeader);
+                const BlockHeader& header = block.header;
+                if (std::memcmp(header.magic, BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) != 0 || header.count == 0
+                    || header.count > BLOCK_RECORDS || header.payloadBytes > size - block.offset) {
+                    break;
+                }
+                pos = block.offset + header.payloadBytes;
+                // Only the last block can be torn, so only its payload is checked up front
+                if (pos + sizeof(BlockHeader) > size && Crc32(data + block.offset, header.payloadBytes) != header.crc) break;
+                sealedLoans = header.firstSequence + header.count;
+                blocks.push_back(block);
+                validBytes = pos;
+            }
+        }
+    } // unmap before resizing the file
+    if (validBytes != size) {
+        std::error_code ec;
+        std::filesystem::resize_file(path, validBytes, ec);
+    }
+
+    file = std::fopen(path.c_str(), "ab");
+    fileBytes = validBytes;
+    if (!file) return false;
+    LoadTailLocked();
+    return true;
+}
+
+void LoanArchive::Close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) return;
+    SealFullBlocksLocked();
+    SyncFile(file);
+    SaveTailLocked();
+    std::fclose(file);
+    file = nullptr;
+}
+
+std::uint64_t LoanArchive::Append(const ArchivedLoan& loan) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::uint64_t sequence = sealedLoans + pending.size();
+    pending.push_back(loan);
+    SealFullBlocksLocked();
+    return sequence;
+}
+
+// Threads commit their journal records in any order, so a sequence number can arrive
+// after a later one; the slots in between stay empty (loanID 0) until theirs arrives.
+void LoanArchive::Restore(std::uint64_t sequence, const ArchivedLoan& loan) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (sequence < sealedLoans) return; // archived before the crash
+    const std::size_t slot = static_cast<std::size_t>(sequence - sealedLoans);
+    if (slot >= pending.size()) pending.resize(slot + 1);
+    if (pending[slot].loanID == 0) pending[slot] = loan;
+}
+
+bool LoanArchive::Flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file) return true;
+    SealFullBlocksLocked();
+    // The blocks go to disk before the tail stops listing their loans
+    const bool synced = SyncFile(file) && std::ferror(file) == 0;
+    return SaveTailLocked() && synced;
+}
+
+std::uint64_t LoanArchive::Size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return sealedLoans + pending.size();
+}
+
+std::size_t LoanArchive::BlockCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return blocks.size();
+}
+
+void LoanArchive::SealFullBlocksLocked() {
+    if (!file) return;
+    std::size_t first = 0;
+    for (; pending.size() - first >= BLOCK_RECORDS; first += BLOCK_RECORDS) {
+        SealBlock(std::vector<ArchivedLoan>(pending.begin() + first, pending.begin() + first + BLOCK_RECORDS));
+    }
+    pending.erase(pending.begin(), pending.begin() + first);
+}
+
+// Written beside the archive and swapped in whole, so a crash leaves the old tail or the new
+bool LoanArchive::SaveTailLocked() {
+    const std::string tailPath = path + ".tail";
+    std::error_code ec;
+    if (pending.empty()) {
+        std::filesystem::remove(tailPath, ec);
+        return !ec;
+    }
+    std::string payload;
+    Encode(pending, payload);
+    TailHeader header{};
+    std::memcpy(header.magic, TAIL_MAGIC, sizeof(TAIL_MAGIC));
+    header.count = static_cast<std::uint32_t>(pending.size());
+    header.payloadBytes = static_cast<std::uint32_t>(payload.size());
+    header.crc = Crc32(payload.data(), payload.size());
+    header.firstSequence = sealedLoans;
+
+    const std::string tmpPath = tailPath + ".tmp";
+    std::FILE* out = std::fopen(tmpPath.c_str(), "wb");
+    if (!out) return false;
+    std::fwrite(&header, sizeof(header), 1, out);
+    std::fwrite(payload.data(), 1, payload.size(), out);
+    const bool written = std::ferror(out) == 0;
+    if (std::fclose(out) != 0 || !written) return false;
+    return DurableRename(tmpPath, tailPath);
+}
+
+// A tail that is missing or damaged is skipped; the journal still holds its loans then
+void LoanArchive::LoadTailLocked() {
+    MappedFile mapped;
+    if (!mapped.Open(path + ".tail") || mapped.Size() < sizeof(TailHeader)) return;
+    TailHeader header;
+    std::memcpy(&header, mapped.Data(), sizeof(header));
+    const char* payload = mapped.Data() + sizeof(header);
+    std::vector<ArchivedLoan> loans;
+    if (std::memcmp(header.magic, TAIL_MAGIC, sizeof(TAIL_MAGIC)) != 0 || header.count > BLOCK_RECORDS
+        || header.payloadBytes != mapped.Size() - sizeof(header) || Crc32(payload, header.payloadBytes) != header.crc
+        || !Decode(payload, header.payloadBytes, header.count, loans)) {
+        return;
+    }
+    for (std::size_t i = 0; i < loans.size(); ++i) {
+        const std::uint64_t sequence = header.firstSequence + i;
+        if (sequence < sealedLoans || loans[i].loanID == 0) continue; // sealed since this tail was saved
+        const std::size_t slot = static_cast<std::size_t>(sequence - sealedLoans);
+        if (slot >= pending.size()) pending.resize(slot + 1);
+        pending[slot] = loans[i];
+    }
+}
+
+void LoanArchive::SealBlock(const std::vector<ArchivedLoan>& loans) {
+    Block block{};
+    BlockHeader& header = block.header;
+    std::memcpy(header.magic, BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+    header.count = static_cast<std::uint32_t>(loans.size());
+    header.firstSequence = sealedLoans;
+    header.minReturned = header.maxReturned = loans.front().returnedEpoch;
+    header.minPatron = header.maxPatron = loans.front().patronID;
+    header.minBook = header.maxBook = loans.front().bookID;
+    for (const ArchivedLoan& loan : loans) {
+        header.minReturned = std::min(header.minReturned, loan.returnedEpoch);
+        header.maxReturned = std::max(header.maxReturned, loan.returnedEpoch);
+        header.minPatron = std::min(header.minPatron, loan.patronID);
+        header.maxPatron = std::max(header.maxPatron, loan.patronID);
+        header.minBook = std::min(header.minBook, loan.bookID);
+        header.maxBook = std::max(header.maxBook, loan.bookID);
+        BloomAdd(header.patronBloom, loan.patronID);
+        BloomAdd(header.bookBloom, loan.bookID);
+    }
+    std::string payload;
+    Encode(loans, payload);
+    header.payloadBytes = static_cast<std::uint32_t>(payload.size());
+    header.crc = Crc32(payload.data(), payload.size());
+
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fwrite(payload.data(), 1, payload.size(), file);
+    std::fflush(file);
+    block.offset = fileBytes + sizeof(header);
+    fileBytes = block.offset + payload.size();
+    blocks.push_back(block);
+    sealedLoans += loans.size();
+}
+
+// One column after another, so each column's small deltas sit together
+void LoanArchive::Encode(const std::vector<ArchivedLoan>& loans, std::string& payload) {
+    payload.reserve(loans.size() * 12);
+    std::int64_t previous = 0;
+    for (const ArchivedLoan& loan : loans) {
+        putVarint(payload, zigzag(loan.returnedEpoch - previous));
+        previous = loan.returnedEpoch;
+    }
+    for (const ArchivedLoan& loan : loans) putVarint(payload, zigzag(loan.dueEpoch - loan.returnedEpoch));
+    previous = 0;
+    for (const ArchivedLoan& loan : loans) {
+        putVarint(payload, zigzag(static_cast<std::int64_t>(loan.loanID) - previous));
+        previous = loan.loanID;
+    }
+    for (const ArchivedLoan& loan : loans) putVarint(payload, zigzag(loan.bookID));
+    for (const ArchivedLoan& loan : loans) putVarint(payload, zigzag(loan.patronID));
+    for (const ArchivedLoan& loan : loans) putVarint(payload, zigzag(loan.fineCents));
+}
+
+bool LoanArchive::Decode(const char* data, std::size_t size, std::uint32_t count, std::vector<ArchivedLoan>& loans) {
+    loans.assign(count, ArchivedLoan{});
+    VarintReader in(data, size);
+    std::int64_t previous = 0;
+    for (ArchivedLoan& loan : loans) loan.returnedEpoch = previous += in.NextSigned();
+    for (ArchivedLoan& loan : loans) loan.dueEpoch = loan.returnedEpoch + in.NextSigned();
+    previous = 0;
+    for (ArchivedLoan& loan : loans) loan.loanID = static_cast<int>(previous += in.NextSigned());
+    for (ArchivedLoan& loan : loans) loan.bookID = static_cast<int>(in.NextSigned());
+    for (ArchivedLoan& loan : loans) loan.patronID = static_cast<int>(in.NextSigned());
+    for (ArchivedLoan& loan : loans) loan.fineCents = in.NextSigned();
+    return in.good() && in.atEnd();
+}
+
+// Two bits per ID, taken from one multiplicative hash
+void LoanArchive::BloomAdd(std::array<std::uint64_t, BLOOM_WORDS>& bloom, int id) {
+    const std::uint64_t h = static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) * 0x9E3779B97F4A7C15ull;
+    const std::uint64_t a = h >> 52, b = (h >> 40) & 0xFFF;
+    bloom[a / 64] |= 1ull << (a % 64);
+    bloom[b / 64] |= 1ull << (b % 64);
+}
+
+bool LoanArchive::BloomMayContain(const std::array<std::uint64_t, BLOOM_WORDS>& bloom, int id) {
+    const std::uint64_t h = static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) * 0x9E3779B97F4A7C15ull;
+    const std::uint64_t a = h >> 52, b = (h >> 40) & 0xFFF;
+    return (bloom[a / 64] >> (a % 64) & 1) && (bloom[b / 64] >> (b % 64) & 1);
+}
+
+template <typename BlockTest, typename LoanTest>
+std::vector<ArchivedLoan> LoanArchive::Query(BlockTest blockTest, LoanTest loanTest) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<ArchivedLoan> matches;
+    MappedFile mapped;
+    if (!blocks.empty() && mapped.Open(path)) {
+        std::vector<ArchivedLoan> decoded;
+        for (const Block& block : blocks) {
+            const BlockHeader& header = block.header;
+            if (!blockTest(header)) continue;
+            if (block.offset + header.payloadBytes > mapped.Size()) break;
+            const char* payload = mapped.Data() + block.offset;
+            if (Crc32(payload, header.payloadBytes) != header.crc) continue; // damaged on disk
+            if (!Decode(payload, header.payloadBytes, header.count, decoded)) continue;
+            for (const ArchivedLoan& loan : decoded) {
+                if (loan.loanID != 0 && loanTest(loan)) matches.push_back(loan);
+            }
+        }
+    }
+    for (const ArchivedLoan& loan : pending) {
+        if (loan.loanID != 0 && loanTest(loan)) matches.push_back(loan);
+    }
+    return matches;
+}
+
+std::vector<ArchivedLoan> LoanArchive::ForPatron(int patronID) const {
+    return Query(
+        [&](const BlockHeader& header) {
+            return patronID >= header.minPatron && patronID <= header.maxPatron
+                && BloomMayContain(header.patronBloom, patronID);
+        },
+        [&](const ArchivedLoan& loan) { return loan.patronID == patronID; });
+}
+
+std::vector<ArchivedLoan> LoanArchive::ForBook(int bookID) const {
+    return Query(
+        [&](const BlockHeader& header) {
+            return bookID >= header.minBook && bookID <= header.maxBook && BloomMayContain(header.bookBloom, bookID);
+        },
+        [&](const ArchivedLoan& loan) { return loan.bookID == bookID; });
+}
+
+std::vector<ArchivedLoan> LoanArchive::ReturnedBetween(std::int64_t fromEpoch, std::int64_t toEpoch) const {
+    return Query(
+        [&](const BlockHeader& header) { return header.maxReturned >= fromEpoch && header.minReturned <= toEpoch; },
+        [&](const ArchivedLoan& loan) { return loan.returnedEpoch >= fromEpoch && loan.returnedEpoch <= toEpoch; });
+}
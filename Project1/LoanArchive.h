@@ -0,0 +1,125 @@
+#ifndef LOANARCHIVE_H
+#define LOANARCHIVE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// A loan after it was checked in
+struct ArchivedLoan {
+    int loanID = 0;
+    int bookID = 0;
+    int patronID = 0;
+    std::int64_t dueEpoch = 0;
+    std::int64_t returnedEpoch = 0;
+    std::int64_t fineCents = 0; // late fee charged at checkin
+};
+
+// Append-only history of returned loans, kept on disk so that only active loans stay in
+// memory.
+//
+// Loans are appended in checkin order and sealed into blocks of BLOCK_RECORDS. A block is
+// stored column by column: return times as zig-zag varint deltas from the previous one,
+// due times as deltas from the return time, loan IDs as deltas, and the remaining fields
+// as varints, which packs a loan into about a dozen bytes. Each block has a header with
+// its record count, CRC, the min/max return time, patron ID and book ID, and a small
+// Bloom filter of the patron and book IDs in it.
+//
+// Only the block headers are read when the archive is opened, and they stay in memory as
+// the index. A query checks each header and decodes just the blocks that can match,
+// reading them through a memory mapping, so years of history are searchable without
+// being loaded. Loans that do not fill a block yet are kept in memory, and Flush writes
+// them to a small tail file next to the archive (path + ".tail"), so the archive itself
+// only ever holds full blocks.
+//
+// Every archived loan gets a sequence number, its position in the archive. The journal
+// logs it, so replaying a journal after a crash adds each loan once. Safe to call from
+// several threads (one internal lock).
+class LoanArchive {
+public:
+    static const std::size_t BLOCK_RECORDS = 1024;
+
+    LoanArchive();
+    ~LoanArchive();
+    LoanArchive(const LoanArchive&) = delete;
+    LoanArchive& operator=(const LoanArchive&) = delete;
+
+    // Opens (or creates) the archive file, reads its block index and the tail file. A torn
+    // last block is cut off. Without an open file the archive only keeps loans in memory.
+    bool Open(const std::string& path);
+    void Close(); // flushes first
+
+    // Adds a returned loan; returns its sequence number
+    std::uint64_t Append(const ArchivedLoan& loan);
+
+    // Journal replay: stores the loan under its sequence number unless the archive already
+    // holds it. A number whose record never made it to the journal is left as an empty slot.
+    // Nothing is sealed until the next Append or Flush, so slots can be filled in any order.
+    void Restore(std::uint64_t sequence, const ArchivedLoan& loan);
+
+    // Seals every full block, then replaces the tail file with the rest; both are fsynced
+    bool Flush();
+
+    // Loans archived so far
+    std::uint64_t Size() const;
+    std::size_t BlockCount() const;
+
+    // Archived loans of a patron, a book, or returned in [fromEpoch, toEpoch], in checkin order
+    std::vector<ArchivedLoan> ForPatron(int patronID) const;
+    std::vector<ArchivedLoan> ForBook(int bookID) const;
+    std::vector<ArchivedLoan> ReturnedBetween(std::int64_t fromEpoch, std::int64_t toEpoch) const;
+
+private:
+    static const std::size_t BLOOM_WORDS = 64; // 4096 bits per key kind
+
+    // On-disk block header (host byte order, like the snapshot). Also the in-memory
+    // index entry, with offset pointing at the payload.
+    struct BlockHeader {
+        char magic[4];
+        std::uint32_t count;
+        std::uint32_t payloadBytes;
+        std::uint32_t crc;        // of the payload
+        std::uint64_t firstSequence;
+        std::int64_t minReturned;
+        std::int64_t maxReturned;
+        std::int32_t minPatron;
+        std::int32_t maxPatron;
+        std::int32_t minBook;
+        std::int32_t maxBook;
+        std::array<std::uint64_t, BLOOM_WORDS> patronBloom;
+        std::array<std::uint64_t, BLOOM_WORDS> bookBloom;
+    };
+    static_assert(sizeof(BlockHeader) == 1080, "archive block header layout changed");
+
+    struct Block {
+        BlockHeader header;
+        std::uint64_t offset; // of the payload in the file
+    };
+
+    // Decides per block header whether the block can hold a match, then per loan
+    template <typename BlockTest, typename LoanTest>
+    std::vector<ArchivedLoan> Query(BlockTest blockTest, LoanTest loanTest) const;
+
+    void SealFullBlocksLocked(); // seals pending from the front while a full block is there
+    bool SaveTailLocked();
+    void LoadTailLocked();
+    void SealBlock(const std::vector<ArchivedLoan>& loans);
+    static void Encode(const std::vector<ArchivedLoan>& loans, std::string& payload);
+    static bool Decode(const char* data, std::size_t size, std::uint32_t count, std::vector<ArchivedLoan>& loans);
+    static void BloomAdd(std::array<std::uint64_t, BLOOM_WORDS>& bloom, int id);
+    static bool BloomMayContain(const std::array<std::uint64_t, BLOOM_WORDS>& bloom, int id);
+
+    mutable std::mutex mutex;
+    std::string path;
+    std::FILE* file;
+    std::uint64_t fileBytes;
+    std::vector<Block> blocks;         // index of the sealed blocks
+    std::uint64_t sealedLoans;         // loans in sealed blocks
+    std::vector<ArchivedLoan> pending; // not yet sealed; the tail file holds them once flushed
+};
+
+#endif // LOANARCHIVE_H
@@ -0,0 +1,108 @@
+#include "LoanColumns.h"
+#include <limits>
+
+// Pick the widest kernel the compiler is allowed to emit. MSVC defines __AVX2__ under
+// /arch:AVX2 and always has SSE2 on x64; everything else falls back to scalar code.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LOANCOLUMNS_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LOANCOLUMNS_SSE2 1
+#endif
+
+static const std::size_t BLOCK = 64; // rows per bitmap word
+
+void LoanColumns::Reserve(std::uint32_t row) {
+    if (row < status.size()) return;
+    // Pad to whole 64-row blocks so the kernels never need a tail loop
+    std::size_t rows = (static_cast<std::size_t>(row) / BLOCK + 1) * BLOCK;
+    if (rows < status.size() * 2) rows = status.size() * 2;
+    loanID.resize(rows, 0);
+    bookID.resize(rows, 0);
+    patronID.resize(rows, 0);
+    dueEpoch.resize(rows, std::numeric_limits<std::int64_t>::max());
+    status.resize(rows, FREE);
+}
+
+void LoanColumns::Set(std::uint32_t row, const Loans& loan) {
+    Reserve(row);
+    loanID[row] = loan.getLoanID();
+    bookID[row] = loan.getBookID();
+    patronID[row] = loan.getPatronID();
+    dueEpoch[row] = loan.getDueEpoch();
+    status[row] = static_cast<std::uint8_t>(loan.getStatus());
+}
+
+void LoanColumns::Clear(std::uint32_t row) {
+    if (row >= status.size()) return;
+    status[row] = FREE;
+    dueEpoch[row] = std::numeric_limits<std::int64_t>::max();
+}
+
+void LoanColumns::SetStatus(std::uint32_t row, Loans::LoanStatus newStatus) {
+    if (row < status.size()) status[row] = static_cast<std::uint8_t>(newStatus);
+}
+
+void LoanColumns::SetDueEpoch(std::uint32_t row, std::int64_t newDue) {
+    if (row < dueEpoch.size()) dueEpoch[row] = newDue;
+}
+
+// One bitmap word: bit i set when status[base + i] < RETURNED
+static std::uint64_t activeWord(const std::uint8_t* s) {
+#if defined(LOANCOLUMNS_AVX2)
+    const __m256i limit = _mm256_set1_epi8(static_cast<char>(Loans::RETURNED));
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 32));
+    std::uint64_t bitsLo = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(limit, lo)));
+    std::uint64_t bitsHi = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(limit, hi)));
+    return bitsLo | (bitsHi << 32);
+#elif defined(LOANCOLUMNS_SSE2)
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(Loans::RETURNED));
+    std::uint64_t bits = 0;
+    for (int i = 0; i < 4; ++i) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16 * i));
+        bits |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmplt_epi8(v, limit)))) << (16 * i);
+    }
+    return bits;
+#else
+    std::uint64_t bits = 0;
+    for (std::size_t i = 0; i < BLOCK; ++i) bits |= static_cast<std::uint64_t>(s[i] < Loans::RETURNED) << i;
+    return bits;
+#endif
+}
+
+// One bitmap word: bit i set when due[base + i] < now
+static std::uint64_t dueBeforeWord(const std::int64_t* due, std::int64_t now) {
+#if defined(LOANCOLUMNS_AVX2)
+    const __m256i nowVec = _mm256_set1_epi64x(now);
+    std::uint64_t bits = 0;
+    for (int i = 0; i < 16; ++i) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(due + 4 * i));
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(nowVec, v)));
+        bits |= static_cast<std::uint64_t>(mask) << (4 * i);
+    }
+    return bits;
+#else
+    // SSE2 has no 64-bit compare; this branch-free loop vectorizes well on its own
+    std::uint64_t bits = 0;
+    for (std::size_t i = 0; i < BLOCK; ++i) bits |= static_cast<std::uint64_t>(due[i] < now) << i;
+    return bits;
+#endif
+}
+
+void LoanColumns::SelectActive(std::vector<std::uint64_t>& bitmap) const {
+    bitmap.assign(status.size() / BLOCK, 0);
+    for (std::size_t w = 0; w < bitmap.size(); ++w) {
+        bitmap[w] = activeWord(status.data() + w * BLOCK);
+    }
+}
+
+void LoanColumns::SelectOverdue(std::int64_t now, std::vector<std::uint64_t>& bitmap) const {
+    bitmap.assign(status.size() / BLOCK, 0);
+    for (std::size_t w = 0; w < bitmap.size(); ++w) {
+        std::uint64_t active = activeWord(status.data() + w * BLOCK);
+        if (active == 0) continue;
+        bitmap[w] = active & dueBeforeWord(dueEpoch.data() + w * BLOCK, now);
+    }
+}
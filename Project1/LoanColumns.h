@@ -0,0 +1,46 @@
+#ifndef LOANCOLUMNS_H
+#define LOANCOLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Loans.h"
+
+// Structure-of-arrays copy of the loan table, one row per LoansCollection slot.
+// Bulk filters run over these columns with SIMD kernels and return a selection
+// bitmap (bit r of word r / 64 is set when row r matches).
+class LoanColumns {
+public:
+    // Row status values; FREE marks a slot with no loan in it
+    static constexpr std::uint8_t FREE = 3;
+
+    // Writes every column for a row, growing the table if needed
+    void Set(std::uint32_t row, const Loans& loan);
+
+    // Marks a row as holding no loan
+    void Clear(std::uint32_t row);
+
+    void SetStatus(std::uint32_t row, Loans::LoanStatus status);
+    void SetDueEpoch(std::uint32_t row, std::int64_t dueEpoch);
+
+    // Rows in the table, rounded up to a multiple of 64
+    std::size_t Rows() const { return status.size(); }
+
+    // Rows with status NORMAL or OVERDUE (status != RETURNED, not FREE)
+    void SelectActive(std::vector<std::uint64_t>& bitmap) const;
+
+    // Active rows whose due epoch is before now
+    void SelectOverdue(std::int64_t now, std::vector<std::uint64_t>& bitmap) const;
+
+    // Columns are public for the row-at-a-time readers that consume a bitmap
+    std::vector<std::int32_t> loanID;
+    std::vector<std::int32_t> bookID;
+    std::vector<std::int32_t> patronID;
+    std::vector<std::int64_t> dueEpoch;
+    std::vector<std::uint8_t> status;
+
+private:
+    void Reserve(std::uint32_t row);
+};
+
+#endif // LOANCOLUMNS_H
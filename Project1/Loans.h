@@ -2,32 +2,38 @@
 #define LOANS_H
 
 //#include <string>
-#include <ctime>
+#include <atomic>
+#include <cstdint>
 
 class Loans {
 public:
-    enum LoanStatus { NORMAL, OVERDUE, RETURNED};
+    enum LoanStatus { NORMAL, OVERDUE, RETURNED}; // returned loans move to the LoanArchive at checkin
     
-    Loans(int bookID, int patronID, std::tm dueDate);
+    // dueEpoch is the due instant in seconds since the Unix epoch
+    Loans(int bookID, int patronID, std::int64_t dueEpoch);
 
     int getLoanID() const;
     int getBookID() const;
     int getPatronID() const;
-    std::tm getDueDate() const;
+    std::int64_t getDueEpoch() const;
     LoanStatus getStatus() const;
 
     void setLoanID(int id);
     void setBookID(int id);
     void setPatronID(int id);
-    void setDueDate(const std::tm& date);
+    void setDueEpoch(std::int64_t epoch);
     void setStatus(LoanStatus status);
 
+    // Next ID the constructor will hand out (saved and restored with a snapshot)
+    static int getNextLoanID();
+    static void setNextLoanID(int id);
+
 private:
-    static int nextLoanID; // Static member to track the next available loan ID
+    static std::atomic<int> nextLoanID; // Static member to track the next available loan ID
+    std::int64_t dueEpoch; // first so the record packs into 24 bytes
     int loanID;
     int bookID;
     int patronID;
-    std::tm dueDate;
     LoanStatus status;
 };
 
@@ -1,9 +1,13 @@
 #include "LoansCollection.h"
+#include "Journal.h"
+#include "Epoch.h"
+#include "ReportWriter.h"
 #include <iostream>
 #include <ctime>
 #include <algorithm>
 #include <string>
-#include <iomanip>
+#include <bit>
+#include <mutex>
 
 //This is the original work; delete the comment section if the new ones don't work.
 /*std::tm getCurrentDate() {
@@ -17,47 +21,38 @@
     return tm;
 }*/
 
-//NEW Section: -------------------- This uses helper functions to prevent linker errors.
-static std::tm getCurrentDate() {
-    std::time_t t = std::time(nullptr);
+std::string tmToString(const std::tm& date) {
+    char buffer[40]; // room for date and time
+    // Western order: month-day-year and time HH:MM:SS
+    strftime(buffer, sizeof(buffer), "%m-%d-%Y %H:%M:%S", &date);
+    return std::string(buffer);
+}
+
+// Loans keep epoch seconds; std::tm is only built here, for display
+static std::string epochToString(std::int64_t epoch) {
+    std::time_t t = static_cast<std::time_t>(epoch);
     std::tm tm;
 #if defined(_MSC_VER)
-    // Microsoft secure version
     localtime_s(&tm, &t);
 #else
-    // POSIX version
     localtime_r(&t, &tm);
 #endif
-    return tm;
-}
-//---------------------------------
-
-std::string tmToString(const std::tm& date) {
-    char buffer[40]; // room for date and time
-    // Western order: month-day-year and time HH:MM:SS
-    strftime(buffer, sizeof(buffer), "%m-%d-%Y %H:%M:%S", &date);
-    return std::string(buffer);
+    return tmToString(tm);
 }
 
 //NEW Section: -------------------- This checks to see if the loan is overdue
-static bool isOverDue(const std::tm& dueDate) {
-    std::time_t now = std::time(nullptr);
-	std::tm dueCopy = dueDate; // Create a copy to avoid modifying the original
-    std::time_t due = std::mktime(&dueCopy);
-	return std::difftime(now, due) > 0; // If now is after due, it's overdue
+static bool isOverDue(std::int64_t dueEpoch) {
+    std::int64_t now = static_cast<std::int64_t>(std::time(nullptr));
+    return now > dueEpoch; // If now is after due, it's overdue
 }
 //---------------------------------
 
 //New Section: -------------------- This Calculates the exact overdue time in weeks, days, hours, minutes, and seconds.
-static std::string getDetailedOverdueTime(const std::tm& dueDate) {
-    std::time_t now = std::time(nullptr);
-    std::tm dueCopy = dueDate;
-    std::time_t due = std::mktime(&dueCopy);
+static std::string getDetailedOverdueTime(std::int64_t dueEpoch) {
+    std::int64_t now = static_cast<std::int64_t>(std::time(nullptr));
 
-    double diffSeconds = std::difftime(now, due);
-    if (diffSeconds <= 0) { return std::string("Not overdue"); }
-
-    long long totalSeconds = static_cast<long long>(diffSeconds);
+    long long totalSeconds = now - dueEpoch;
+    if (totalSeconds <= 0) { return std::string("Not overdue"); }
 
     int weeks = static_cast<int>(totalSeconds / (7 * 24 * 3600));
     totalSeconds %= (7LL * 24 * 3600);
@@ -81,94 +76,567 @@ static std::string getDetailedOverdueTime(const std::tm& dueDate) {
     return result;
 }
 
-int calculateDaysDifference(const std::tm& dueDate, const std::tm& currentDate) {
-    std::time_t due_time = std::mktime(const_cast<std::tm*>(&dueDate));
-    std::time_t current_time = std::mktime(const_cast<std::tm*>(&currentDate));
-    const double secondsPerDay = 60 * 60 * 24;
-    return static_cast<int>(std::difftime(due_time, current_time) / secondsPerDay);
+SlabHandle LoansCollection::AddLoan(int bookID, int patronID, std::int64_t dueEpoch, int loanID) {
+    SlabHandle handle = loansList.Emplace(bookID, patronID, dueEpoch);
+    if (loanID != 0) loansList.Get(handle)->setLoanID(loanID);
+    loanColumns.Set(handle.index, *loansList.Get(handle));
+    loansByPatron[patronID].push_back(handle);
+    loanByBook[bookID] = handle;
+    ScheduleDue(handle);
+    return handle;
 }
 
-void LoansCollection::CheckOutBook(PatronsCollection &allPatrons, BooksCollection &allBooks) {
-    Patron* patron = allPatrons.PromptForSearchMechanism();
-    if (!patron) {
-        std::cout << "Patron not found.\n";
-        return;
+void LoansCollection::ScheduleDue(SlabHandle handle) {
+    Loans* loan = loansList.Get(handle);
+    loansByID[loan->getLoanID()] = handle;
+
+    if (loan->getStatus() == Loans::OVERDUE) {
+        loan->setStatus(Loans::NORMAL);
+        overdueLoans.erase(loan->getLoanID());
+        fines.Drop(loan->getLoanID()); // already settled, or replayed with the patron's balance
     }
-    if (patron->getFineBalance() > 0) {
-        std::cout << "Patron has outstanding fines. Cannot checkout until fines are paid.\n";
-        return;
+    loanColumns.SetStatus(handle.index, loan->getStatus());
+    loanColumns.SetDueEpoch(handle.index, loan->getDueEpoch());
+    dueQueue.push(DueEntry(loan->getDueEpoch(), loan->getLoanID()));
+    CompactDueQueue();
+}
+
+void LoansCollection::CompactDueQueue() {
+    if (dueQueue.size() <= 2 * loansByID.size() + 64) return;
+
+    std::vector<DueEntry> live;
+    live.reserve(loansByID.size());
+    loansList.ForEach([&](SlabHandle, const Loans& loan) {
+        if (loan.getStatus() == Loans::NORMAL) live.push_back(DueEntry(loan.getDueEpoch(), loan.getLoanID()));
+    });
+    dueQueue = decltype(dueQueue)(std::greater<DueEntry>(), std::move(live));
+}
+
+void LoansCollection::RemoveLoan(SlabHandle handle) {
+    const Loans* loan = loansList.Get(handle);
+    if (!loan) return;
+
+    auto byPatron = loansByPatron.find(loan->getPatronID());
+    if (byPatron != loansByPatron.end()) {
+        auto& patronLoans = byPatron->second;
+        patronLoans.erase(std::remove(patronLoans.begin(), patronLoans.end(), handle), patronLoans.end());
+        if (patronLoans.empty()) loansByPatron.erase(byPatron);
     }
-    if (!patron->canCheckout()) {
-        std::cout << "You can only have 3 books checked Out." << std::endl;
+    auto byBook = loanByBook.find(loan->getBookID());
+    if (byBook != loanByBook.end() && byBook->second == handle) loanByBook.erase(byBook);
+    loansByID.erase(loan->getLoanID());
+    overdueLoans.erase(loan->getLoanID());
+    fines.Drop(loan->getLoanID());
+
+    loanColumns.Clear(handle.index);
+    loansList.Erase(handle); // the slot is recycled by the next checkout
+}
+
+void LoansCollection::InsertLoan(int loanID, int bookID, int patronID, std::int64_t dueEpoch, Loans::LoanStatus status) {
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    SlabHandle handle = AddLoan(bookID, patronID, dueEpoch, loanID);
+    loansList.Get(handle)->setStatus(status);
+    loanColumns.SetStatus(handle.index, status);
+}
+
+void LoansCollection::UpsertLoan(int loanID, int bookID, int patronID, std::int64_t dueEpoch, Loans::LoanStatus status) {
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    auto it = loansByID.find(loanID);
+    if (it == loansByID.end()) {
+        SlabHandle handle = AddLoan(bookID, patronID, dueEpoch, loanID);
+        loansList.Get(handle)->setStatus(status);
+        loanColumns.SetStatus(handle.index, status);
         return;
     }
+    Loans* loan = loansList.Get(it->second);
+    loan->setDueEpoch(dueEpoch);
+    ScheduleDue(it->second);
+}
 
-    Books* book = allBooks.PromptForSearchMechanism();
-    if (!book || book->getCurrentBookStatus() != Books::IN) {
-        std::cout << "Book not available.\n";
-        return;
+bool LoansCollection::RemoveLoanByID(int loanID) {
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    auto it = loansByID.find(loanID);
+    if (it == loansByID.end()) return false;
+    RemoveLoan(it->second);
+    return true;
+}
+
+void LoansCollection::SetJournal(Journal* j) { journal = j; }
+
+void LoansCollection::SetArchive(LoanArchive* a) { archive = a; }
+
+void LoansCollection::RestoreArchivedLoan(std::uint64_t sequence, const ArchivedLoan& loan) {
+    if (archive) archive->Restore(sequence, loan);
+}
+
+void LoansCollection::Reserve(std::size_t count) {
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    loansList.Reserve(count);
+    loanByBook.reserve(count);
+    loansByID.reserve(count);
+}
+
+SlabHandle LoansCollection::FindLoanByBookID(int bookID) const {
+    auto it = loanByBook.find(bookID);
+    return it != loanByBook.end() ? it->second : SlabHandle{};
+}
+
+// The patron's and the book's record locks make each check-and-update below atomic for
+// that pair without serializing unrelated checkouts; loansMutex is only held while the
+// loan indexes change. When a copy of the title is already set aside for the patron and
+// they take another one, the set-aside copy is passed on in the same transaction, so its
+// record lock is taken too (looked up first, and rechecked once all locks are held).
+ResultCode LoansCollection::Checkout(PatronsCollection &allPatrons, BooksCollection &allBooks,
+                                     int patronID, int bookID, std::int64_t now) {
+    while (true) {
+        std::uint64_t isbn;
+        {
+            Epoch::ReadGuard guard;
+            const Books* book = allBooks.FindBookByID(bookID);
+            if (!book) return ResultCode::BOOK_NOT_FOUND;
+            isbn = book->getPackedISBN();
+        }
+        int heldCopy = ReadyCopyFor(patronID, isbn);
+        if (heldCopy == bookID) heldCopy = 0;
+
+        std::unique_lock<std::mutex> patronRecord(allPatrons.RecordLock(patronID), std::defer_lock);
+        std::unique_lock<std::mutex> bookRecord(allBooks.RecordLock(bookID), std::defer_lock);
+        std::unique_lock<std::mutex> heldRecord;
+        if (heldCopy != 0 && &allBooks.RecordLock(heldCopy) != &allBooks.RecordLock(bookID)) {
+            heldRecord = std::unique_lock<std::mutex>(allBooks.RecordLock(heldCopy), std::defer_lock);
+            std::lock(patronRecord, bookRecord, heldRecord);
+        } else {
+            std::lock(patronRecord, bookRecord);
+        }
+
+        Patron* patron = allPatrons.FindPatronByID(patronID);
+        if (!patron) return ResultCode::PATRON_NOT_FOUND;
+        if (patron->getFineBalance() > 0) return ResultCode::OUTSTANDING_FINES;
+        if (!patron->canCheckout()) return ResultCode::LOAN_LIMIT_REACHED;
+
+        Books* book = allBooks.FindBookByID(bookID);
+        if (!book) return ResultCode::BOOK_NOT_FOUND;
+        if (book->getPackedISBN() != isbn) continue; // edited meanwhile
+        const Books::BookStatus status = book->getCurrentBookStatus();
+        if (status != Books::IN && status != Books::ON_HOLD) return ResultCode::BOOK_NOT_AVAILABLE;
+        Books* held = heldCopy != 0 ? allBooks.FindBookByID(heldCopy) : nullptr;
+
+        {
+            std::unique_lock<std::shared_mutex> lock(loansMutex);
+            // A copy set aside goes only to the patron it is held for
+            const Hold* hold = status == Books::ON_HOLD ? holds.ReadyFor(bookID) : nullptr;
+            if (status == Books::ON_HOLD && (!hold || hold->patronID != patronID)) return ResultCode::BOOK_NOT_AVAILABLE;
+            if (!hold) hold = holds.FindForPatron(patronID, isbn);
+            const int readyCopy = hold && hold->status == Hold::READY && hold->bookID != bookID ? hold->bookID : 0;
+            if (readyCopy != heldCopy) continue; // served or released meanwhile
+            SweepDue(now);
+            if (fines.AccruingFor(patronID) > 0) return ResultCode::OUTSTANDING_FINES;
+            SlabHandle handle = AddLoan(bookID, patronID, DueEpochFor(book->getMaterial(), now));
+            if (journal) journal->LogLoan(*loansList.Get(handle));
+
+            // The loan fills the patron's hold on the title. A copy set aside for it that
+            // the patron did not take goes to the next patron in line.
+            bool heldSetAside = false;
+            if (hold) {
+                if (journal) journal->LogHoldDeleted(hold->holdID);
+                holds.Remove(hold->holdID);
+                if (held) heldSetAside = PassToNextHold(isbn, heldCopy, now);
+            }
+            if (held) allBooks.SetBookStatus(*held, heldSetAside ? Books::ON_HOLD : Books::IN);
+        }
+
+        allBooks.SetBookStatus(*book, Books::OUT);
+        // Use Patron helper to increment with limit checking
+        patron->checkoutBook();
+
+        if (journal) {
+            journal->LogBook(*book);
+            if (held) journal->LogBook(*held);
+            journal->LogPatron(*patron);
+            journal->Commit();
+        }
+        return ResultCode::OK;
+    }
+}
+
+ResultCode LoansCollection::Checkin(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID, int bookID,
+                                    std::int64_t now) {
+    std::scoped_lock records(allPatrons.RecordLock(patronID), allBooks.RecordLock(bookID));
+    Patron* patron = allPatrons.FindPatronByID(patronID);
+    if (!patron) return ResultCode::PATRON_NOT_FOUND;
+    Books* book = allBooks.FindBookByID(bookID);
+    if (!book) return ResultCode::BOOK_NOT_FOUND;
+
+    {
+        std::unique_lock<std::shared_mutex> lock(loansMutex);
+        SlabHandle handle = FindLoanByBookID(bookID);
+        const Loans* loan = loansList.Get(handle);
+        if (!loan || loan->getPatronID() != patronID) return ResultCode::LOAN_NOT_FOUND;
+        SweepDue(now);
+        const std::int64_t fineCents = SettleFine(*patron, *loan, now);
+        if (archive) {
+            ArchivedLoan returned;
+            returned.loanID = loan->getLoanID();
+            returned.bookID = bookID;
+            returned.patronID = patronID;
+            returned.dueEpoch = loan->getDueEpoch();
+            returned.returnedEpoch = now;
+            returned.fineCents = fineCents;
+            const std::uint64_t sequence = archive->Append(returned);
+            if (journal) journal->LogLoanArchived(sequence, returned);
+        }
+        if (journal) journal->LogLoanDeleted(loan->getLoanID());
+        RemoveLoan(handle);
+
+        // The copy goes straight to the next patron waiting for the title, if any
+        const bool setAside = PassToNextHold(book->getPackedISBN(), bookID, now);
+        allBooks.SetBookStatus(*book, setAside ? Books::ON_HOLD : Books::IN);
+    }
+
+    patron->setNumBooks(patron->getNumBooks() - 1);
+    if (journal) {
+        journal->LogBook(*book);
+        journal->LogPatron(*patron);
+        journal->Commit();
+    }
+    return ResultCode::OK;
+}
+
+ResultCode LoansCollection::Renew(PatronsCollection &allPatrons, BooksCollection &allBooks,
+                                  int patronID, int bookID, std::int64_t now) {
+    // A book's loan changes under its lock; the patron's is held for the fine settled here
+    std::scoped_lock records(allPatrons.RecordLock(patronID), allBooks.RecordLock(bookID));
+    Patron* patron = allPatrons.FindPatronByID(patronID);
+    if (!patron) return ResultCode::PATRON_NOT_FOUND;
+    const Books* book = allBooks.FindBookByID(bookID);
+    if (!book) return ResultCode::BOOK_NOT_FOUND;
+
+    {
+        std::unique_lock<std::shared_mutex> lock(loansMutex);
+        SlabHandle handle = FindLoanByBookID(bookID);
+        Loans* loan = loansList.Get(handle);
+        if (!loan || loan->getPatronID() != patronID) return ResultCode::LOAN_NOT_FOUND;
+        if (holds.Waiting(book->getPackedISBN()) > 0) return ResultCode::HOLDS_WAITING;
+
+        SweepDue(now);
+        SettleFine(*patron, *loan, now);
+        loan->setDueEpoch(DueEpochFor(book->getMaterial(), now)); // a fresh loan period from today
+        ScheduleDue(handle);
+        if (journal) journal->LogLoan(*loan);
+    }
+    if (journal) {
+        journal->LogPatron(*patron);
+        journal->Commit();
+    }
+    return ResultCode::OK;
+}
+
+ResultCode LoansCollection::MarkLost(BooksCollection &allBooks, int bookID) {
+    std::lock_guard<std::mutex> record(allBooks.RecordLock(bookID));
+    Books* book = allBooks.FindBookByID(bookID);
+    if (!book) return ResultCode::BOOK_NOT_FOUND;
+    {
+        std::shared_lock<std::shared_mutex> lock(loansMutex);
+        if (FindLoanByBookID(bookID).isNull()) return ResultCode::LOAN_NOT_FOUND;
+    }
+
+    allBooks.SetBookStatus(*book, Books::LOST);
+    if (journal) {
+        journal->LogBook(*book);
+        journal->Commit();
+    }
+    return ResultCode::OK;
+}
+
+ResultCode LoansCollection::RemoveCopy(BooksCollection &allBooks, int bookID) {
+    std::lock_guard<std::mutex> record(allBooks.RecordLock(bookID));
+    // Held across the delete, so no hold can be placed or served between the check and it
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    const Books* book = allBooks.FindBookByID(bookID);
+    if (!book) return ResultCode::BOOK_NOT_FOUND;
+    if (!FindLoanByBookID(bookID).isNull()) return ResultCode::BOOK_NOT_AVAILABLE;
+    if (holds.ReadyFor(bookID)) return ResultCode::HOLDS_WAITING;
+    const std::uint64_t isbn = book->getPackedISBN();
+    if (holds.Waiting(isbn) > 0 && allBooks.CopiesOf(isbn) == 1) return ResultCode::HOLDS_WAITING;
+
+    if (journal) {
+        journal->LogBookDeleted(bookID);
+        journal->Commit();
+    }
+    allBooks.RemoveBook(bookID);
+    return ResultCode::OK;
+}
+
+std::int64_t LoansCollection::SettleFine(Patron& patron, const Loans& loan, std::int64_t now) {
+    const std::int64_t cents = fines.Settle(loan.getLoanID(), now);
+    if (cents > 0) patron.setFineBalance(patron.getFineBalance() + static_cast<float>(cents) / 100.0f);
+    return cents;
+}
+
+void LoansCollection::SetFinePolicy(const FinePolicy& policy) {
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    fines.SetPolicy(policy);
+}
+
+void LoansCollection::SetLoanDays(Books::Material material, int days) {
+    if (material < 0 || material >= Books::MATERIAL_COUNT || days < 0) return;
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    loanDays[material] = days;
+}
+
+void LoansCollection::SetCalendar(const LibraryCalendar& calendar) {
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    this->calendar = calendar; // fines keeps referring to the member
+}
+
+// Due dates fall on open days only and run to the end of that day, so a loan is never
+// due on a closed day and a book returned on its due date is on time.
+std::int64_t LoansCollection::DueEpochFor(Books::Material material, std::int64_t now) const {
+    return EndOfOpenDay(now, loanDays[material]);
+}
+
+std::int64_t LoansCollection::EndOfOpenDay(std::int64_t now, int days) const {
+    const std::int64_t day = calendar.NextOpenDay(LibraryCalendar::LocalDay(now) + days);
+    return LibraryCalendar::LocalStartOfDay(day + 1) - 1;
+}
+
+ResultCode LoansCollection::PlaceHold(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID,
+                                      int bookID, std::int64_t now, int priority) {
+    std::scoped_lock records(allPatrons.RecordLock(patronID), allBooks.RecordLock(bookID));
+    if (!allPatrons.FindPatronByID(patronID)) return ResultCode::PATRON_NOT_FOUND;
+    const Books* book = allBooks.FindBookByID(bookID);
+    if (!book) return ResultCode::BOOK_NOT_FOUND;
+    const std::uint64_t isbn = book->getPackedISBN();
+
+    {
+        // Copies are shelved under loansMutex, so none can come back between this check
+        // and the hold going into the queue
+        std::unique_lock<std::shared_mutex> lock(loansMutex);
+        if (allBooks.AvailableCopies(*book) > 0) return ResultCode::COPY_AVAILABLE;
+        if (holds.FindForPatron(patronID, isbn)) return ResultCode::ALREADY_ON_HOLD;
+        const int holdID = holds.Place(patronID, isbn, priority, now);
+        if (journal) journal->LogHold(*holds.Find(holdID));
+    }
+    if (journal) journal->Commit();
+    return ResultCode::OK;
+}
+
+// A ready hold's copy changes status, so its record lock has to be taken before
+// loansMutex; the hold is looked up first and rechecked once both are held.
+ResultCode LoansCollection::CancelHold(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID,
+                                       int holdID, std::int64_t now) {
+    while (true) {
+        int bookID;
+        {
+            std::shared_lock<std::shared_mutex> lock(loansMutex);
+            const Hold* hold = holds.Find(holdID);
+            if (!hold || hold->patronID != patronID) return ResultCode::HOLD_NOT_FOUND;
+            bookID = hold->status == Hold::READY ? hold->bookID : 0;
+        }
+
+        std::unique_lock<std::mutex> patronRecord(allPatrons.RecordLock(patronID), std::defer_lock);
+        std::unique_lock<std::mutex> bookRecord;
+        if (bookID != 0) {
+            bookRecord = std::unique_lock<std::mutex>(allBooks.RecordLock(bookID), std::defer_lock);
+            std::lock(patronRecord, bookRecord);
+        } else {
+            patronRecord.lock();
+        }
+
+        Books* book = bookID != 0 ? allBooks.FindBookByID(bookID) : nullptr;
+        {
+            std::unique_lock<std::shared_mutex> lock(loansMutex);
+            const Hold* hold = holds.Find(holdID);
+            if (!hold || hold->patronID != patronID) return ResultCode::HOLD_NOT_FOUND;
+            if ((hold->status == Hold::READY ? hold->bookID : 0) != bookID) continue; // served meanwhile
+            if (journal) journal->LogHoldDeleted(holdID);
+            const std::uint64_t isbn = hold->isbn;
+            holds.Remove(holdID);
+            if (book) allBooks.SetBookStatus(*book, PassToNextHold(isbn, bookID, now) ? Books::ON_HOLD : Books::IN);
+        }
+        if (book && journal) journal->LogBook(*book);
+        if (journal) journal->Commit();
+        return ResultCode::OK;
+    }
+}
+
+// Expired holds are collected under loansMutex, then released one copy at a time under
+// that copy's record lock (taken before loansMutex, as everywhere else)
+void LoansCollection::ExpireHolds(BooksCollection &allBooks, std::int64_t now) {
+    std::vector<int> expired;
+    {
+        std::unique_lock<std::shared_mutex> lock(loansMutex);
+        holds.TakeExpired(now, expired);
+    }
+    for (int holdID : expired) {
+        int bookID;
+        {
+            std::shared_lock<std::shared_mutex> lock(loansMutex);
+            const Hold* hold = holds.Find(holdID);
+            if (!hold || hold->status != Hold::READY) continue;
+            bookID = hold->bookID;
+        }
+        std::lock_guard<std::mutex> record(allBooks.RecordLock(bookID));
+        Books* book = allBooks.FindBookByID(bookID);
+        {
+            std::unique_lock<std::shared_mutex> lock(loansMutex);
+            const Hold* hold = holds.Find(holdID);
+            if (!hold || hold->status != Hold::READY || hold->bookID != bookID || hold->expiresEpoch > now) continue;
+            if (journal) journal->LogHoldDeleted(holdID);
+            const std::uint64_t isbn = hold->isbn;
+            holds.Remove(holdID);
+            if (book) allBooks.SetBookStatus(*book, PassToNextHold(isbn, bookID, now) ? Books::ON_HOLD : Books::IN);
+        }
+        if (book && journal) journal->LogBook(*book);
+        if (journal) journal->Commit();
     }
+}
+
+bool LoansCollection::PassToNextHold(std::uint64_t isbn, int bookID, std::int64_t now) {
+    const Hold* next = holds.AssignNext(isbn, bookID, EndOfOpenDay(now, pickupDays));
+    if (next && journal) journal->LogHold(*next);
+    return next != nullptr;
+}
+
+void LoansCollection::SetPickupDays(int days) {
+    if (days < 0) return;
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    pickupDays = days;
+}
+
+int LoansCollection::ReadyCopyFor(int patronID, std::uint64_t isbn) const {
+    std::shared_lock<std::shared_mutex> lock(loansMutex);
+    const Hold* hold = holds.FindForPatron(patronID, isbn);
+    return hold && hold->status == Hold::READY ? hold->bookID : 0;
+}
+
+int LoansCollection::HeldFor(int bookID) const {
+    std::shared_lock<std::shared_mutex> lock(loansMutex);
+    const Hold* hold = holds.ReadyFor(bookID);
+    return hold ? hold->patronID : 0;
+}
+
+void LoansCollection::UpsertHold(const Hold& hold) {
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    holds.Restore(hold);
+}
 
-    std::tm dueDate = getCurrentDate(); 
-    dueDate.tm_mday += 7; 
-    mktime(&dueDate); 
-    Loans* loan = new Loans(book->getLibraryID(), patron->getPatronID(), dueDate);
+bool LoansCollection::RemoveHoldByID(int holdID) {
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    return holds.Remove(holdID);
+}
 
+int LoansCollection::GetNextHoldID() const {
+    std::shared_lock<std::shared_mutex> lock(loansMutex);
+    return holds.NextHoldID();
+}
 
-    loan->setBookID(book->getLibraryID());
-    loan->setPatronID(patron->getPatronID());
-    loansList.push_back(loan);
+void LoansCollection::SetNextHoldID(int id) {
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    holds.SetNextHoldID(id);
+}
 
-    book->setCurrentBookStatus(Books::OUT);
-    // Use Patron helper to increment with limit checking
-    patron->checkoutBook();
+float LoansCollection::AccruingFine(int patronID) const {
+    std::shared_lock<std::shared_mutex> lock(loansMutex);
+    return static_cast<float>(fines.AccruingFor(patronID)) / 100.0f;
+}
 
+std::int64_t LoansCollection::DueEpochOf(int bookID) const {
+    std::shared_lock<std::shared_mutex> lock(loansMutex);
+    const Loans* loan = loansList.Get(FindLoanByBookID(bookID));
+    return loan ? loan->getDueEpoch() : 0;
+}
+
+void LoansCollection::CheckOutBook(PatronsCollection &allPatrons, BooksCollection &allBooks) {
+    const int patronID = allPatrons.PromptForSearchMechanism();
+    {
+        Epoch::ReadGuard guard; // keeps the looked-up patron alive while it is read
+        const Patron* patron = allPatrons.FindPatronByID(patronID);
+        if (!patron) {
+            std::cout << "Patron not found.\n";
+            return;
+        }
+        if (patron->getFineBalance() > 0) {
+            std::cout << "Patron has outstanding fines. Cannot checkout until fines are paid.\n";
+            return;
+        }
+        if (!patron->canCheckout()) {
+            std::cout << "You can only have 3 books checked Out." << std::endl;
+            return;
+        }
+    }
+
+    int bookID = allBooks.PromptForSearchMechanism();
+    {
+        // Title and ISBN searches land on the first copy; take the copy set aside for this
+        // patron's hold, or else any copy that is on the shelf. Checkout re-checks it under the locks.
+        Epoch::ReadGuard guard;
+        Books* book = allBooks.FindBookByID(bookID);
+        if (book && book->getCurrentBookStatus() != Books::IN) {
+            const int heldCopy = ReadyCopyFor(patronID, book->getPackedISBN());
+            const Books* copy = heldCopy ? allBooks.FindBookByID(heldCopy) : allBooks.FindAvailableCopy(*book);
+            if (copy) bookID = copy->getLibraryID();
+        }
+    }
+    ResultCode result = bookID ? Checkout(allPatrons, allBooks, patronID, bookID,
+                                          static_cast<std::int64_t>(std::time(nullptr)))
+                               : ResultCode::BOOK_NOT_FOUND;
+    if (result == ResultCode::OUTSTANDING_FINES) {
+        std::cout << "Patron has an overdue book accruing fines. Cannot checkout until it is returned.\n";
+        return;
+    }
+    if (result != ResultCode::OK) {
+        std::cout << "Book not available.";
+        if (bookID) std::cout << " Choose Place a Hold to join the waiting list.";
+        std::cout << "\n";
+        return;
+    }
     std::cout << "Book checked out successfully.\n";
 }
 
 void LoansCollection::CheckInBook(PatronsCollection &allPatrons, BooksCollection &allBooks) {
-    Patron* patron = allPatrons.PromptForSearchMechanism();
-    if (patron == nullptr) {
+    const int patronID = allPatrons.PromptForSearchMechanism();
+    if (!patronID) {
         std::cout << "Patron not found.\n";
         return;
     }
 
-    Books* book = allBooks.PromptForSearchMechanism();
-    if (book == nullptr) {
+    const int bookID = allBooks.PromptForSearchMechanism();
+    if (!bookID) {
         std::cout << "Book not found.\n";
         return;
     }
 
-    auto it = std::find_if(loansList.begin(), loansList.end(), [&](Loans* loan) {
-        return loan->getPatronID() == patron->getPatronID() && loan->getBookID() == book->getLibraryID();
-    });
-
-    if (it != loansList.end()) {
-        // Save pointer before erasing the iterator (erase invalidates the iterator)
-        Loans* loanPtr = *it;
-        loansList.erase(it);
-        delete loanPtr; // free the dynamically allocated loan
-        book->setCurrentBookStatus(Books::IN);
-        patron->setNumBooks(patron->getNumBooks() - 1);
+    if (Checkin(allPatrons, allBooks, patronID, bookID,
+                static_cast<std::int64_t>(std::time(nullptr))) == ResultCode::OK) {
         std::cout << "Book checked in successfully." << std::endl;
-        std::cout << "You still have " << patron->getNumBooks() << " book(s) checked out." << std::endl;
+        {
+            Epoch::ReadGuard guard; // keeps the looked-up patron alive while it is read
+            if (const Patron* patron = allPatrons.FindPatronByID(patronID)) {
+                std::cout << "You still have " << patron->getNumBooks() << " book(s) checked out." << std::endl;
+            }
+        }
+        if (int heldFor = HeldFor(bookID)) {
+            std::cout << "Set this copy aside: it is on hold for patron ID " << heldFor << "." << std::endl;
+        }
     } else {
         std::cout << "Loan record not found.\n";
     }
 }
 
 void LoansCollection::ListAllOverdueBooks() {
+    AutoUpdateLoanStatus();
+    std::shared_lock<std::shared_mutex> lock(loansMutex);
+
     std::cout << "Overdue Books:\n";
     bool found = false;
-    for (auto* loan : loansList) {
-        std::tm dueDate = loan->getDueDate();
-        std::tm today = getCurrentDate();
-        // If dueDate is before today, the difference (due - today) will be negative.
-        // We consider a loan overdue when today is after the due date.
-        if (calculateDaysDifference(dueDate, today) < 0) {
-            std::cout << "Loan ID " << loan->getLoanID() << " is overdue.\n";
-            found = true;
-        }
+    const std::int64_t today = LibraryCalendar::LocalDay(std::time(nullptr));
+    for (const auto& entry : overdueLoans) {
+        const Loans* loan = loansList.Get(entry.second);
+        const std::int64_t dueEpoch = loan->getDueEpoch();
+        std::cout << "Loan ID " << entry.first << " is overdue (due " << epochToString(dueEpoch) << ", "
+                  << calendar.OpenDaysAfter(LibraryCalendar::LocalDay(dueEpoch), today) << " open day(s) late).\n";
+        found = true;
     }
 
     if (!found) {
@@ -178,159 +646,361 @@ void LoansCollection::ListAllOverdueBooks() {
 }
 
 void LoansCollection::ListAllCheckedOutBooks(BooksCollection &allBooks) {
-    std::cout << "Checked Out Books:\n";
+    ReportWriter out;
+    ListAllCheckedOutBooks(allBooks, out);
+}
+
+void LoansCollection::ListAllCheckedOutBooks(BooksCollection &allBooks, ReportWriter &out) {
+    AutoUpdateLoanStatus();
+    std::shared_lock<std::shared_mutex> lock(loansMutex);
+
+    Epoch::ReadGuard guard; // keeps the looked-up books alive while their titles are printed
+    out << "Checked Out Books:\n";
     bool found = false;
-    for (auto* loan : loansList) {
-        if (loan->getStatus() != Loans::RETURNED) {
-            Books* book = allBooks.FindBookByID(loan->getBookID());
-            std::string title = book ? book->getTitle() : std::string("<unknown>");
-            std::cout << "Loan ID " << loan->getLoanID() << ", Book ID " << loan->getBookID()
-                      << ", Title: " << title << ", Patron ID " << loan->getPatronID()
-                      << ", Due Date: " << tmToString(loan->getDueDate()) << "\n";
+    std::vector<std::uint64_t> selected;
+    loanColumns.SelectActive(selected);
+    for (std::size_t w = 0; w < selected.size(); ++w) {
+        for (std::uint64_t bits = selected[w]; bits != 0; bits &= bits - 1) {
+            std::size_t row = w * 64 + std::countr_zero(bits);
+            Books* book = allBooks.FindBookByID(loanColumns.bookID[row]);
+            std::string_view title = book ? book->getTitle() : std::string_view("<unknown>");
+            out << "Loan ID " << loanColumns.loanID[row] << ", Book ID " << loanColumns.bookID[row]
+                << ", Title: " << title << ", Patron ID " << loanColumns.patronID[row]
+                << ", Due Date: " << ReportWriter::DateTime{ loanColumns.dueEpoch[row] } << '\n';
             found = true;
         }
     }
     if (!found) {
-        std::cout << "There are no checked out books" << std::endl;
+        out << "There are no checked out books\n";
     }
 }
 
 void LoansCollection::ListBooksForPatron(PatronsCollection &allPatrons, BooksCollection &allBooks) {
-    Patron* patron = allPatrons.PromptForSearchMechanism();
-    if (!patron) {
-        std::cout << "Patron not found.\n";
-        return;
+    const int patronID = allPatrons.PromptForSearchMechanism();
+    ReportWriter out;
+    {
+        Epoch::ReadGuard guard; // keeps the looked-up patron alive while its name is printed
+        const Patron* patron = allPatrons.FindPatronByID(patronID);
+        if (!patron) {
+            std::cout << "Patron not found.\n";
+            return;
+        }
+        out << "Books checked out by " << patron->getName() << ":\n";
     }
-    std::cout << "Books checked out by " << patron->getName() << ":\n";
+    PrintLoansForPatron(patronID, allBooks, out);
+}
+
+void LoansCollection::ListBooksForPatronByID(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID) {
+    ReportWriter out;
+    ListBooksForPatronByID(allPatrons, allBooks, patronID, out);
+}
 
-    int count = 0;
-    for (auto* loan : loansList) {
-        if (loan->getPatronID() == patron->getPatronID() && loan->getStatus() != Loans::LoanStatus::RETURNED) {
-            ++count;
+void LoansCollection::ListBooksForPatronByID(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID,
+                                             ReportWriter &out) {
+    {
+        Epoch::ReadGuard guard; // keeps the looked-up patron alive while its name is printed
+        const Patron* patron = allPatrons.FindPatronByID(patronID);
+        if (patron == nullptr) {
+            out << "Patron not found.\n";
+            return;
         }
+        out << "Books checked out by " << patron->getName() << " (ID: " << patronID << "):\n";
     }
+    PrintLoansForPatron(patronID, allBooks, out);
+}
+
+void LoansCollection::PrintLoansForPatron(int patronID, BooksCollection &allBooks, ReportWriter &out) {
+    AutoUpdateLoanStatus();
+    std::shared_lock<std::shared_mutex> lock(loansMutex);
 
+    // Returned loans leave loansList at checkin, so every loan here is still out
+    auto byPatron = loansByPatron.find(patronID);
+    const std::size_t count = byPatron != loansByPatron.end() ? byPatron->second.size() : 0;
     if (count == 0) {
-        std::cout << "No books currently checked out by this patron." << std::endl;
+        out << "No books currently checked out by this patron.\n";
         return;
     }
 
-    std::cout << "You still have " << count << " book(s) checked out." << std::endl;
-    for (auto* loan : loansList) {
-        if (loan->getPatronID() == patron->getPatronID() && loan->getStatus() != Loans::LoanStatus::RETURNED) {
-            Books* book = allBooks.FindBookByID(loan->getBookID());
-            if (book) {
-                std::cout << " - Loan ID: " << loan->getLoanID()
-                          << ", Book ID: " << book->getLibraryID()
-                          << ", Title: " << book->getTitle()
-                          << ", Cost: $" << std::fixed << std::setprecision(2) << book->getCost()
-                          << ", Due: " << tmToString(loan->getDueDate())
-                          << ", Status: " << (loan->getStatus() == Loans::OVERDUE ? "Overdue" : "Checked Out")
-                          << std::endl;
+    out << "You still have " << count << " book(s) checked out.\n";
+    Epoch::ReadGuard guard; // keeps the looked-up books alive while they are printed
+    for (SlabHandle handle : byPatron->second) {
+        const Loans* loan = loansList.Get(handle);
+        Books* book = allBooks.FindBookByID(loan->getBookID());
+        if (book) {
+            out << " - Loan ID: " << loan->getLoanID()
+                << ", Book ID: " << book->getLibraryID()
+                << ", Title: " << book->getTitle()
+                << ", Cost: $" << ReportWriter::Fixed{ book->getCost(), 2 }
+                << ", Due: " << ReportWriter::DateTime{ loan->getDueEpoch() }
+                << ", Status: " << (loan->getStatus() == Loans::OVERDUE ? "Overdue" : "Checked Out")
+                << '\n';
+        }
+    }
+}
+
+void LoansCollection::AutoUpdateLoanStatus() {
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    SweepDue(static_cast<std::int64_t>(std::time(nullptr)));
+}
+
+void LoansCollection::SweepDue(std::int64_t now) {
+    // A loan is overdue once the current time is past its due time
+    while (!dueQueue.empty() && dueQueue.top().first < now) {
+        DueEntry entry = dueQueue.top();
+        dueQueue.pop();
+
+        auto it = loansByID.find(entry.second);
+        if (it == loansByID.end()) continue; // loan was checked in
+        Loans* loan = loansList.Get(it->second);
+        if (loan->getDueEpoch() != entry.first || loan->getStatus() != Loans::NORMAL) continue; // stale entry
+
+        loan->setStatus(Loans::OVERDUE);
+        loanColumns.SetStatus(it->second.index, Loans::OVERDUE);
+        overdueLoans[entry.second] = it->second;
+        fines.Start(entry.second, loan->getPatronID(), loan->getDueEpoch(), now);
+    }
+    fines.AccrueUntil(now);
+}
+
+void LoansCollection::RecomputeOverdueStatus() {
+    std::unique_lock<std::shared_mutex> lock(loansMutex);
+    std::int64_t now = static_cast<std::int64_t>(std::time(nullptr));
+    std::vector<std::uint64_t> active, overdue;
+    loanColumns.SelectActive(active);
+    loanColumns.SelectOverdue(now, overdue);
+
+    overdueLoans.clear();
+    fines.Clear();
+    std::vector<DueEntry> pending;
+    pending.reserve(loansByID.size());
+    for (std::size_t w = 0; w < active.size(); ++w) {
+        for (std::uint64_t bits = active[w]; bits != 0; bits &= bits - 1) {
+            std::size_t row = w * 64 + std::countr_zero(bits);
+            int loanID = loanColumns.loanID[row];
+            SlabHandle handle = loansByID[loanID];
+            Loans::LoanStatus status = ((overdue[w] >> (row % 64)) & 1) ? Loans::OVERDUE : Loans::NORMAL;
+
+            loansList.Get(handle)->setStatus(status);
+            loanColumns.SetStatus(handle.index, status);
+            if (status == Loans::OVERDUE) {
+                overdueLoans[loanID] = handle;
+                fines.Start(loanID, loanColumns.patronID[row], loanColumns.dueEpoch[row], now);
+            } else {
+                pending.push_back(DueEntry(loanColumns.dueEpoch[row], loanID));
             }
         }
     }
+    dueQueue = decltype(dueQueue)(std::greater<DueEntry>(), std::move(pending));
 }
 
-void LoansCollection::ListBooksForPatronByID(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID) {
-    Patron* patron = allPatrons.FindPatronByID(patronID);
-    if (patron == nullptr) {
+
+void LoansCollection::PlaceHoldOnBook(PatronsCollection &allPatrons, BooksCollection &allBooks) {
+    const int patronID = allPatrons.PromptForSearchMechanism();
+    if (!patronID) {
         std::cout << "Patron not found.\n";
         return;
     }
+    const int bookID = allBooks.PromptForSearchMechanism();
+    if (!bookID) {
+        std::cout << "Book not found.\n";
+        return;
+    }
 
-    std::cout << "Books checked out by " << patron->getName() << " (ID: " << patronID << "):\n";
-    int found = 0;
-    for (auto* loan : loansList) {
-        if (loan->getPatronID() == patronID && loan->getStatus() != Loans::LoanStatus::RETURNED) {
-            ++found;
+    switch (PlaceHold(allPatrons, allBooks, patronID, bookID, static_cast<std::int64_t>(std::time(nullptr)))) {
+        case ResultCode::OK: {
+            std::uint64_t isbn = 0;
+            {
+                Epoch::ReadGuard guard; // keeps the looked-up book alive while its ISBN is read
+                if (const Books* book = allBooks.FindBookByID(bookID)) isbn = book->getPackedISBN();
+            }
+            std::size_t waiting;
+            {
+                std::shared_lock<std::shared_mutex> lock(loansMutex);
+                waiting = holds.Waiting(isbn);
+            }
+            std::cout << "Hold placed. " << waiting << " patron(s) waiting for this title.\n";
+            break;
         }
+        case ResultCode::COPY_AVAILABLE:
+            std::cout << "A copy is on the shelf; check it out instead.\n";
+            break;
+        case ResultCode::ALREADY_ON_HOLD:
+            std::cout << "This patron already has a hold on this title.\n";
+            break;
+        default:
+            std::cout << "Hold could not be placed.\n";
     }
+}
 
-    if (found == 0) {
-        std::cout << "No books currently checked out by this patron." << std::endl;
+void LoansCollection::CancelHoldForPatron(PatronsCollection &allPatrons, BooksCollection &allBooks) {
+    const int patronID = allPatrons.PromptForSearchMechanism();
+    if (!patronID) {
+        std::cout << "Patron not found.\n";
         return;
     }
 
-    std::cout << "You still have " << found << " book(s) checked out." << std::endl;
-    for (auto* loan : loansList) {
-        if (loan->getPatronID() == patronID && loan->getStatus() != Loans::LoanStatus::RETURNED) {
-            Books* book = allBooks.FindBookByID(loan->getBookID());
-            if (book) {
-                std::cout << " - Loan ID: " << loan->getLoanID()
-                          << ", Book ID: " << book->getLibraryID()
-                          << ", Title: " << book->getTitle()
-                          << ", Cost: $" << std::fixed << std::setprecision(2) << book->getCost()
-                          << ", Due: " << tmToString(loan->getDueDate())
-                          << ", Status: " << (loan->getStatus() == Loans::OVERDUE ? "Overdue" : "Checked Out")
-                          << std::endl;
+    std::vector<Hold> patronHolds;
+    {
+        std::shared_lock<std::shared_mutex> lock(loansMutex);
+        holds.ForPatron(patronID, [&](const Hold& hold) { patronHolds.push_back(hold); });
+    }
+    if (patronHolds.empty()) {
+        std::cout << "This patron has no holds.\n";
+        return;
+    }
+    {
+        Epoch::ReadGuard guard; // keeps the looked-up books alive while their titles are printed
+        for (const Hold& hold : patronHolds) {
+            const Books* book = hold.status == Hold::READY ? allBooks.FindBookByID(hold.bookID)
+                                                           : allBooks.FindBookByISBN(Books::UnpackISBN(hold.isbn));
+            std::cout << " - Hold ID: " << hold.holdID
+                      << ", Title: " << (book ? book->getTitle() : std::string_view("<unknown>"))
+                      << ", ISBN: " << Books::UnpackISBN(hold.isbn);
+            if (hold.status == Hold::READY) {
+                std::cout << ", Ready: Book ID " << hold.bookID << " until " << epochToString(hold.expiresEpoch);
+            } else {
+                std::cout << ", Waiting";
             }
+            std::cout << "\n";
         }
     }
+
+    std::string line;
+    std::cout << "Enter the hold ID to cancel: ";
+    if (!std::getline(std::cin, line)) return;
+    int holdID = 0;
+    try {
+        holdID = std::stoi(line);
+    } catch (...) {
+        std::cout << "Hold not found.\n";
+        return;
+    }
+    if (CancelHold(allPatrons, allBooks, patronID, holdID,
+                   static_cast<std::int64_t>(std::time(nullptr))) == ResultCode::OK) {
+        std::cout << "Hold cancelled.\n";
+    } else {
+        std::cout << "Hold not found.\n";
+    }
 }
 
-void LoansCollection::AutoUpdateLoanStatus() {
-    std::tm today = getCurrentDate();
-    for (auto* loan : loansList) {
-        if (calculateDaysDifference(loan->getDueDate(), today) > 0) {
-            loan->setStatus(Loans::OVERDUE);
+void LoansCollection::LoanHistory(PatronsCollection &allPatrons, BooksCollection &allBooks) {
+    std::string line;
+    std::cout << "History of (1) a patron or (2) a book: ";
+    if (!std::getline(std::cin, line)) return;
+    ReportWriter out;
+    if (line == "1") {
+        const int patronID = allPatrons.PromptForSearchMechanism();
+        {
+            Epoch::ReadGuard guard; // keeps the looked-up patron alive while its name is printed
+            const Patron* patron = allPatrons.FindPatronByID(patronID);
+            if (!patron) {
+                std::cout << "Patron not found.\n";
+                return;
+            }
+            out << "Loan history of " << patron->getName() << " (ID: " << patronID << "):\n";
         }
+        PrintPatronHistory(allBooks, patronID, out);
+    } else if (line == "2") {
+        const int bookID = allBooks.PromptForSearchMechanism();
+        if (!bookID) {
+            std::cout << "Book not found.\n";
+            return;
+        }
+        out << "Loan history of book ID " << bookID << ":\n";
+        PrintBookHistory(allBooks, bookID, out);
+    } else {
+        std::cout << "Invalid choice.\n";
     }
 }
 
+void LoansCollection::PrintPatronHistory(BooksCollection &allBooks, int patronID, ReportWriter &out) {
+    PrintHistory(archive ? archive->ForPatron(patronID) : std::vector<ArchivedLoan>(), allBooks, out);
+}
+
+void LoansCollection::PrintBookHistory(BooksCollection &allBooks, int bookID, ReportWriter &out) {
+    PrintHistory(archive ? archive->ForBook(bookID) : std::vector<ArchivedLoan>(), allBooks, out);
+}
+
+void LoansCollection::PrintHistory(const std::vector<ArchivedLoan>& history, BooksCollection &allBooks,
+                                   ReportWriter &out) {
+    if (history.empty()) {
+        out << "No returned loans on record.\n";
+        return;
+    }
+    Epoch::ReadGuard guard; // keeps the looked-up books alive while their titles are printed
+    for (auto it = history.rbegin(); it != history.rend(); ++it) {
+        const Books* book = allBooks.FindBookByID(it->bookID);
+        out << " - Loan ID: " << it->loanID
+            << ", Book ID: " << it->bookID
+            << ", Title: " << (book ? book->getTitle() : std::string_view("<unknown>"))
+            << ", Patron ID: " << it->patronID
+            << ", Due: " << ReportWriter::DateTime{ it->dueEpoch }
+            << ", Returned: " << ReportWriter::DateTime{ it->returnedEpoch };
+        if (it->fineCents > 0) out << ", Fine: $" << ReportWriter::Fixed{ it->fineCents / 100.0, 2 };
+        out << '\n';
+    }
+}
 
 void LoansCollection::EditLoan(PatronsCollection &allPatrons, BooksCollection &allBooks) {
     std::cout << "\n--- Editing a Loan Record ---\n";
-    Patron* patron = allPatrons.PromptForSearchMechanism();
-    if (!patron) {
+    const int patronID = allPatrons.PromptForSearchMechanism();
+    if (!patronID) {
         std::cout << "Patron not found.\n";
         return;
     }
 
-    Books* book = allBooks.PromptForSearchMechanism();
-    if (!book) {
+    const int bookID = allBooks.PromptForSearchMechanism();
+    if (!bookID) {
         std::cout << "Book not found.\n";
         return;
     }
 
-    auto it = std::find_if(loansList.begin(), loansList.end(), [&](Loans* loan) {
-        return loan->getPatronID() == patron->getPatronID() && loan->getBookID() == book->getLibraryID();
-    });
-
-    if (it == loansList.end()) {
+    ResultCode result = Renew(allPatrons, allBooks, patronID, bookID, static_cast<std::int64_t>(std::time(nullptr)));
+    if (result == ResultCode::HOLDS_WAITING) {
+        std::cout << "This book cannot be renewed: other patrons are waiting for it.\n";
+        return;
+    }
+    if (result != ResultCode::OK) {
         std::cout << "No active loan found for this book and patron combination.\n";
         return;
     }
-
-    std::tm newDueDate = getCurrentDate();
-    newDueDate.tm_mday += 7; // Extending the due date by 7 days
-    (*it)->setDueDate(newDueDate);
-
-    std::cout << "Loan record updated. New due date: " << tmToString(newDueDate) << ".\n";
+    std::cout << "Loan record updated. New due date: " << epochToString(DueEpochOf(bookID)) << ".\n";
 }
 
 void LoansCollection::ReportLost(PatronsCollection &allPatrons, BooksCollection &allBooks) {
     std::cout << "\n--- Reporting a Book as Lost ---\n";
-    Patron* patron = allPatrons.PromptForSearchMechanism();
-    if (!patron) {
+    const int patronID = allPatrons.PromptForSearchMechanism();
+    if (!patronID) {
         std::cout << "Patron not found.\n";
         return;
     }
 
-    Books* book = allBooks.PromptForSearchMechanism();
-    if (!book) {
+    const int bookID = allBooks.PromptForSearchMechanism();
+    if (!bookID) {
         std::cout << "Book not found.\n";
         return;
     }
 
-    auto it = std::find_if(loansList.begin(), loansList.end(), [&](Loans* loan) {
-        return loan->getBookID() == book->getLibraryID();
-    });
-
-    if (it != loansList.end()) {
-        book->setCurrentBookStatus(Books::LOST);
+    if (MarkLost(allBooks, bookID) == ResultCode::OK) {
         std::cout << "Book marked as lost.\n";
     } else {
         std::cout << "Loan record for the book not found.\n";
     }
 }
+
+void LoansCollection::DeleteBook(BooksCollection &allBooks) {
+    const int bookID = allBooks.PromptForSearchMechanism();
+    switch (RemoveCopy(allBooks, bookID)) {
+        case ResultCode::OK:
+            std::cout << "Book deleted successfully.\n";
+            break;
+        case ResultCode::BOOK_NOT_AVAILABLE:
+            std::cout << "This copy is checked out. Check it in before deleting it.\n";
+            break;
+        case ResultCode::HOLDS_WAITING:
+            std::cout << "Patrons are waiting for this copy. Cancel their holds before deleting it.\n";
+            break;
+        default:
+            std::cout << "Book not found.\n";
+    }
+}
@@ -1,9 +1,26 @@
 #ifndef LOANSCOLLECTION_H
 #define LOANSCOLLECTION_H
 
+#include <array>
 #include <vector>
-#include <ctime>
+#include <map>
+#include <queue>
+#include <unordered_map>
+#include <functional>
+#include <utility>
+#include <cstdint>
+#include <shared_mutex>
 #include "Loans.h"
+#include "SlabStore.h"
+#include "LoanColumns.h"
+#include "FineLedger.h"
+#include "HoldQueues.h"
+#include "LoanArchive.h"
+#include "LibraryCalendar.h"
+#include "ResultCode.h"
+
+class Journal;
+class ReportWriter;
 #include "PatronsCollection.h"
 #include "BooksCollection.h"
 
@@ -23,24 +40,205 @@ public:
     // Lists all currently checked out loans (not returned)
     // Requires access to the books collection to print book titles
     void ListAllCheckedOutBooks(BooksCollection &allBooks);
+    void ListAllCheckedOutBooks(BooksCollection &allBooks, ReportWriter &out);
 
     // Lists all books checked out to a specific patron
     void ListBooksForPatron(PatronsCollection &allPatrons, BooksCollection &allBooks);
 
     // Lists all books checked out to a patron by their ID
     void ListBooksForPatronByID(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID);
+    void ListBooksForPatronByID(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID, ReportWriter &out);
 
-    // Updates the loan status based on the current date
+    // Updates the loan status based on the current date and accrues fines on overdue loans.
+    // Only loans whose due time (or next fine day) has passed since the last sweep are touched.
     void AutoUpdateLoanStatus();
 
+    // Re-derives every active loan's status from scratch with the columnar
+    // overdue kernel and rebuilds the due queue and the accruing fines (nightly batch,
+    // or after a clock change)
+    void RecomputeOverdueStatus();
+
+    // Places a hold on a book's title for a patron
+    void PlaceHoldOnBook(PatronsCollection &allPatrons, BooksCollection &allBooks);
+
+    // Lists a patron's holds and cancels the one chosen
+    void CancelHoldForPatron(PatronsCollection &allPatrons, BooksCollection &allBooks);
+
+    // Prints the returned loans of a patron or of a book, from the archive
+    void LoanHistory(PatronsCollection &allPatrons, BooksCollection &allBooks);
+    void PrintPatronHistory(BooksCollection &allBooks, int patronID, ReportWriter &out);
+    void PrintBookHistory(BooksCollection &allBooks, int bookID, ReportWriter &out);
+
     // Edits a loan, allowing for rechecks
     void EditLoan(PatronsCollection &allPatrons, BooksCollection &allBooks);
 
     // Reports a book as lost
     void ReportLost(PatronsCollection &allPatrons, BooksCollection &allBooks);
 
+    // Removes a copy from the catalogue, unless it is out or holds depend on it
+    void DeleteBook(BooksCollection &allBooks);
+
+    // Circulation core (no console I/O), shared by the interactive menu and batch mode.
+    // Each successful call is one journal transaction; now is the caller's clock in epoch seconds.
+    // Safe to call from several threads: each call locks the records it touches (see
+    // BooksCollection/PatronsCollection::RecordLock) and then loansMutex.
+    ResultCode Checkout(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID, int bookID, std::int64_t now);
+    // A patron with fines accruing on an overdue loan cannot check out. Checking in or
+    // renewing an overdue loan adds the fine it accrued to the patron's balance.
+    ResultCode Checkin(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID, int bookID, std::int64_t now);
+    ResultCode Renew(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID, int bookID, std::int64_t now);
+    ResultCode MarkLost(BooksCollection &allBooks, int bookID);
+    // Refused with BOOK_NOT_AVAILABLE while the copy is out, and with HOLDS_WAITING while it is
+    // set aside for a hold or is the last copy of a title patrons are waiting for, so no hold
+    // is left pointing at a copy that is gone
+    ResultCode RemoveCopy(BooksCollection &allBooks, int bookID);
+
+    // Holds (see HoldQueues). A hold is on a book's title (ISBN) and is served by whichever
+    // copy comes back first: Checkin sets the copy aside (ON_HOLD) for the next patron in
+    // line, who has until the end of the pickupDays-th open day to check it out. A loan
+    // cannot be renewed while others are waiting for its title. A returned or released
+    // copy is shelved under loansMutex, so a hold is never placed next to an IN copy.
+    ResultCode PlaceHold(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID, int bookID,
+                         std::int64_t now, int priority = 0);
+    ResultCode CancelHold(PatronsCollection &allPatrons, BooksCollection &allBooks, int patronID, int holdID,
+                          std::int64_t now);
+    // Passes copies whose pickup deadline is past to the next patron in line, or back to the shelf
+    void ExpireHolds(BooksCollection &allBooks, std::int64_t now);
+    void SetPickupDays(int days); // from LibraryConfig
+
+    // Patron a copy is set aside for, or 0
+    int HeldFor(int bookID) const;
+
+    // Due date of the active loan for a book, or 0 if it is not checked out
+    std::int64_t DueEpochOf(int bookID) const;
+
+    // Late-fee rate and per-loan cap (see FineLedger); main sets it from LibraryConfig
+    void SetFinePolicy(const FinePolicy& policy);
+
+    // Loan period per material, in days. A loan is due at the end of the first open day
+    // at least that many days after checkout (or renewal). Set from LibraryConfig at startup.
+    void SetLoanDays(Books::Material material, int days);
+
+    // Opening calendar used for due dates and fines. Loans already out keep their due
+    // dates; fines accrue by the new calendar from the next sweep on. Set from LibraryConfig.
+    void SetCalendar(const LibraryCalendar& calendar);
+
+    // Fines accrued so far on a patron's overdue loans that are still out, in dollars
+    // (as of the last sweep; not yet part of the patron's balance)
+    float AccruingFine(int patronID) const;
+
+    // Programmatic access (no console I/O), used by persistence.
+    // InsertLoan restores a loan under its original ID; call RecomputeOverdueStatus
+    // once all loans are in to settle their statuses.
+    void InsertLoan(int loanID, int bookID, int patronID, std::int64_t dueEpoch, Loans::LoanStatus status);
+    void Reserve(std::size_t count);
+    std::size_t Count() const {
+        std::shared_lock<std::shared_mutex> lock(loansMutex);
+        return loansList.Size();
+    }
+
+    // Journal replay: store a loan's exact fields (inserting or overwriting), or drop a loan
+    void UpsertLoan(int loanID, int bookID, int patronID, std::int64_t dueEpoch, Loans::LoanStatus status);
+    bool RemoveLoanByID(int loanID);
+
+    // Snapshot load and journal replay of holds, inserting or overwriting
+    void UpsertHold(const Hold& hold);
+    bool RemoveHoldByID(int holdID);
+    int GetNextHoldID() const;
+    void SetNextHoldID(int id);
+
+    // Circulation changes (loan, book status, patron count) are logged here as one
+    // transaction each (may be nullptr)
+    void SetJournal(Journal* journal);
+
+    // Checkin moves returned loans here (may be nullptr: returned loans are dropped). Only
+    // active loans stay in loansList.
+    void SetArchive(LoanArchive* archive);
+    // Journal replay of a returned loan
+    void RestoreArchivedLoan(std::uint64_t sequence, const ArchivedLoan& loan);
+
+    template <typename Fn>
+    void ForEachLoan(Fn fn) const {
+        std::shared_lock<std::shared_mutex> lock(loansMutex);
+        loansList.ForEach([&](SlabHandle, const Loans& loan) { fn(loan); });
+    }
+
+    // Visits every hold, each title's waiting holds in serving order
+    template <typename Fn>
+    void ForEachHold(Fn fn) const {
+        std::shared_lock<std::shared_mutex> lock(loansMutex);
+        holds.ForEach(fn);
+    }
+
 private:
-    std::vector<Loans*> loansList; // Stores pointers to Loans
+    // Adds/removes a loan from loansList and the secondary indexes
+    // loanID 0 keeps the ID the Loans constructor assigned
+    SlabHandle AddLoan(int bookID, int patronID, std::int64_t dueEpoch, int loanID = 0);
+    void RemoveLoan(SlabHandle handle);
+
+    // Records a new due date for an active loan and queues it for the overdue sweep
+    void ScheduleDue(SlabHandle handle);
+
+    // Drops stale entries from dueQueue once they outnumber the active loans
+    void CompactDueQueue();
+
+    // Marks loans due before now as overdue and accrues fines up to now
+    void SweepDue(std::int64_t now);
+
+    // Moves the fine accrued on a loan into its patron's balance and returns it in cents
+    // (caller holds the patron's record lock and loansMutex)
+    std::int64_t SettleFine(Patron& patron, const Loans& loan, std::int64_t now);
+
+    // Prints archived loans, newest first (shared by the Print*History functions)
+    void PrintHistory(const std::vector<ArchivedLoan>& history, BooksCollection &allBooks, ReportWriter &out);
+
+    // Due instant for a loan of the given material made at now
+    std::int64_t DueEpochFor(Books::Material material, std::int64_t now) const;
+
+    // End of the first open day at least days after now
+    std::int64_t EndOfOpenDay(std::int64_t now, int days) const;
+
+    // Copy set aside for the patron's hold on a title, or 0
+    int ReadyCopyFor(int patronID, std::uint64_t isbn) const;
+
+    // Sets a copy that came back aside for the next hold on its title and logs it; false
+    // if nobody is waiting (caller holds the copy's record lock and loansMutex)
+    bool PassToNextHold(std::uint64_t isbn, int bookID, std::int64_t now);
+
+    // Active loan for a book, or a null handle
+    SlabHandle FindLoanByBookID(int bookID) const;
+
+    // Prints the active loans of one patron (shared by the ListBooksForPatron* functions)
+    void PrintLoansForPatron(int patronID, BooksCollection &allBooks, ReportWriter &out);
+
+    SlabStore<Loans> loansList; // Owns the Loans records, stored contiguously
+    Journal* journal = nullptr;
+    LoanArchive* archive = nullptr;
+
+    // Secondary indexes over loansList
+    std::unordered_map<int, std::vector<SlabHandle>> loansByPatron; // patron ID -> active loans
+    std::unordered_map<int, SlabHandle> loanByBook;                 // book ID -> active loan
+    std::unordered_map<int, SlabHandle> loansByID;                  // loan ID -> active loan
+
+    // Min-heap of (due epoch, loan ID) for loans not yet marked overdue. Entries are
+    // removed lazily: one whose loan is gone or whose due time changed is skipped.
+    using DueEntry = std::pair<std::int64_t, int>;
+    std::priority_queue<DueEntry, std::vector<DueEntry>, std::greater<DueEntry>> dueQueue;
+
+    std::map<int, SlabHandle> overdueLoans; // loan ID -> loan already marked OVERDUE
+
+    LibraryCalendar calendar;
+    std::array<int, Books::MATERIAL_COUNT> loanDays{ 7, 3, 7, 14 }; // book, DVD, magazine, audiobook
+    FineLedger fines{ calendar }; // fines accruing on the loans in overdueLoans
+
+    HoldQueues holds;
+    int pickupDays = 3; // open days a copy set aside for a hold waits to be picked up
+
+    // Columnar mirror of loansList (row = slot index) for the bulk scans
+    LoanColumns loanColumns;
+
+    // Guards loansList and everything above; the private helpers expect it to be held
+    mutable std::shared_mutex loansMutex;
 };
 
 #endif // LOANSCOLLECTION_H
@@ -0,0 +1,24 @@
+#ifndef LOCKSTRIPES_H
+#define LOCKSTRIPES_H
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+
+// Fixed pool of mutexes shared by many records: the record with key k is guarded by
+// stripe k % STRIPES. Two records may share a stripe, so two stripes from the same pool
+// are only ever taken together through std::lock, and a shared one only once.
+class LockStripes {
+public:
+    static constexpr std::size_t STRIPES = 64;
+
+    std::mutex& For(int key) { return stripes[static_cast<unsigned int>(key) % STRIPES].mutex; }
+
+private:
+    struct alignas(64) Stripe { // one cache line each, so busy stripes do not share a line
+        std::mutex mutex;
+    };
+    std::array<Stripe, STRIPES> stripes;
+};
+
+#endif // LOCKSTRIPES_H
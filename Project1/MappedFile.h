@@ -0,0 +1,33 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file (MapViewOfFile on Windows, mmap elsewhere).
+// The mapping is released when the object is destroyed or Close() is called.
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps the file; returns false if it cannot be opened or mapped.
+    // An empty file opens successfully with Size() == 0.
+    bool Open(const std::string& path);
+    void Close();
+
+    const char* Data() const { return data; }
+    std::size_t Size() const { return size; }
+
+private:
+    const char* data;
+    std::size_t size;
+#if defined(_WIN32)
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+#endif // MAPPEDFILE_H
@@ -1,19 +1,26 @@
 #include "Patron.h"
 #include <iostream>
+#include <utility>
 
 // Maximum books allowed per patron
 const int Patron::MAX_BOOKS = 3;
 
 // Constructs a Patron with a name and ID.
 Patron::Patron(std::string nm, int ID)
-    : name(nm), patronID(ID), fineBalance(0.0), numBooks(0) {}
+    : name(std::move(nm)), patronID(ID), fineBalance(0.0), numBooks(0) {}
 
 // Default constructor
 Patron::Patron()
     : name(""), patronID(0), fineBalance(0.0), numBooks(0) {}
 
+Patron::Patron(const Patron& other)
+    : name(other.name), patronID(other.patronID), fineBalance(other.fineBalance.load()), numBooks(other.numBooks.load()) {}
+
+Patron::Patron(Patron&& other) noexcept
+    : name(std::move(other.name)), patronID(other.patronID), fineBalance(other.fineBalance.load()), numBooks(other.numBooks.load()) {}
+
 // Getters
-std::string Patron::getName() const {
+std::string_view Patron::getName() const {
     return name;
 }
 
@@ -30,7 +37,7 @@ int Patron::getNumBooks() const {
 }
 
 // Setters
-void Patron::setName(std::string nm) {
+void Patron::setName(std::string_view nm) {
     name = nm;
 }
 
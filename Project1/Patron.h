@@ -1,7 +1,9 @@
 #ifndef PATRON_H
 #define PATRON_H
 
+#include <atomic>
 #include <string>
+#include <string_view>
 
 // The Patron class represents a library patron, holding information about the patron's name,
 // identification number, the amount of fines they owe, and the number of books they've checked out.
@@ -13,8 +15,13 @@ public:
     // Default constructor for creating a blank Patron.
     Patron();
 
-    // Getters for Patron attributes
-    std::string getName() const;
+    // Copy every field (used to publish a new version of a renamed patron, and by bulk loads)
+    Patron(const Patron& other);
+    Patron(Patron&& other) noexcept;
+    Patron& operator=(const Patron&) = delete;
+
+    // Getters for Patron attributes; the name view lives as long as the patron
+    std::string_view getName() const;
     int getPatronID() const;
     float getFineBalance() const;
     int getNumBooks() const;
@@ -26,7 +33,7 @@ public:
     void returnBook();
 
     // Setters for Patron attributes
-    void setName(std::string nm);
+    void setName(std::string_view nm);
     void setPatronID(int ID);
     void setFineBalance(float bal);
     void setNumBooks(int num);
@@ -34,8 +41,10 @@ public:
 private:
     std::string name;
     int patronID;
-    float fineBalance;
-    int numBooks;
+    // Atomic so listings can read them while another terminal updates the patron;
+    // updates themselves are made under PatronsCollection::RecordLock
+    std::atomic<float> fineBalance;
+    std::atomic<int> numBooks;
 };
 
 #endif // PATRON_H
@@ -0,0 +1,131 @@
+#include "PatronNameIndex.h"
+#include "StringPool.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <iterator>
+
+// helpers (file-local)
+namespace {
+
+std::string_view trimView(std::string_view s) {
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front()))) s.remove_prefix(1);
+    while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back()))) s.remove_suffix(1);
+    return s;
+}
+
+std::string fold(std::string_view s) {
+    std::string folded(s);
+    for (char& ch : folded) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    return folded;
+}
+
+} // namespace
+
+void PatronNameIndex::SplitName(std::string_view name, std::string& first, std::string& last) {
+    first.clear();
+    last.clear();
+    name = trimView(name);
+    std::size_t start = 0;
+    while (start < name.size()) {
+        std::size_t end = start;
+        while (end < name.size() && !std::isspace(static_cast<unsigned char>(name[end]))) ++end;
+        if (!last.empty()) {
+            if (!first.empty()) first += ' ';
+            first += last;
+        }
+        last = fold(name.substr(start, end - start));
+        start = end;
+        while (start < name.size() && std::isspace(static_cast<unsigned char>(name[start]))) ++start;
+    }
+}
+
+void PatronNameIndex::Add(int patronID, std::string_view name) {
+    std::string first, last;
+    SplitName(name, first, last);
+    const std::string_view firstKey = StringPool::Intern(first);
+    const std::string_view lastKey = StringPool::Intern(last);
+    byLast.insert(Key{ lastKey, firstKey, patronID });
+    byFirst.insert(Key{ firstKey, lastKey, patronID });
+}
+
+void PatronNameIndex::AddBulk(const std::vector<Entry>& entries) {
+    std::vector<Key> lastKeys, firstKeys;
+    lastKeys.reserve(entries.size());
+    firstKeys.reserve(entries.size());
+    std::string first, last;
+    for (const Entry& entry : entries) {
+        SplitName(entry.name, first, last);
+        const std::string_view firstKey = StringPool::Intern(first);
+        const std::string_view lastKey = StringPool::Intern(last);
+        lastKeys.push_back(Key{ lastKey, firstKey, entry.patronID });
+        firstKeys.push_back(Key{ firstKey, lastKey, entry.patronID });
+    }
+    // In sorted order each key belongs right after the previous one (always so when the
+    // set starts out empty), which the hint turns into an amortized O(1) insert
+    auto insertSorted = [](std::multiset<Key>& keys, std::vector<Key>& added) {
+        std::sort(added.begin(), added.end());
+        auto hint = keys.end();
+        for (const Key& key : added) hint = std::next(keys.insert(hint, key));
+    };
+    insertSorted(byLast, lastKeys);
+    insertSorted(byFirst, firstKeys);
+}
+
+void PatronNameIndex::Remove(int patronID, std::string_view name) {
+    std::string first, last;
+    SplitName(name, first, last);
+    auto it = byLast.find(Key{ last, first, patronID });
+    if (it != byLast.end()) byLast.erase(it);
+    it = byFirst.find(Key{ first, last, patronID });
+    if (it != byFirst.end()) byFirst.erase(it);
+}
+
+void PatronNameIndex::Clear() {
+    byLast.clear();
+    byFirst.clear();
+}
+
+void PatronNameIndex::Scan(const std::multiset<Key>& keys, std::string_view major, bool majorPrefix,
+                           std::string_view minor, bool minorPrefix, std::size_t maxResults, std::vector<int>& out) {
+    auto it = keys.lower_bound(Key{ major, majorPrefix ? std::string_view() : minor, INT_MIN });
+    for (; it != keys.end() && out.size() < maxResults; ++it) {
+        if (majorPrefix ? !it->major.starts_with(major) : it->major != major) break;
+        if (!majorPrefix && (minorPrefix ? !it->minor.starts_with(minor) : it->minor != minor)) break;
+        // A renamed patron can briefly have two keys; report it once
+        if (std::find(out.begin(), out.end(), it->patronID) != out.end()) continue;
+        out.push_back(it->patronID);
+    }
+}
+
+std::vector<int> PatronNameIndex::Search(std::string_view query, std::size_t maxResults) const {
+    std::vector<int> ids;
+    query = trimView(query);
+    if (query.empty() || maxResults == 0) return ids;
+
+    const std::size_t comma = query.find(',');
+    if (comma != std::string_view::npos) {
+        std::string_view initial = trimView(query.substr(comma + 1));
+        while (!initial.empty() && initial.back() == '.') initial.remove_suffix(1);
+        Scan(byLast, fold(trimView(query.substr(0, comma))), false, fold(initial), true, maxResults, ids);
+        return ids;
+    }
+
+    std::string first, last;
+    SplitName(query, first, last);
+    if (!first.empty()) {
+        Scan(byLast, last, false, first, false, maxResults, ids);
+        return ids;
+    }
+    Scan(byLast, last, true, {}, true, maxResults, ids);
+    Scan(byFirst, last, true, {}, true, maxResults, ids);
+    return ids;
+}
+
+std::vector<int> PatronNameIndex::FindExact(std::string_view name, std::size_t maxResults) const {
+    std::vector<int> ids;
+    std::string first, last;
+    SplitName(name, first, last);
+    if (!last.empty()) Scan(byLast, last, false, first, false, maxResults, ids);
+    return ids;
+}
@@ -0,0 +1,95 @@
+#ifndef PATRONNAMEINDEX_H
+#define PATRONNAMEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Sorted index of patron names for lookups at the desk.
+//
+// A name is split into a last name (its last word) and a first name (the words before
+// it), each case-folded and interned in the StringPool. Two ordered sets hold one key per
+// patron: (last, first, ID) and (first, last, ID). Every query is a lower_bound into one
+// set followed by a walk over the matching range, so it costs O(log n + k) for k results.
+// Keys carry the first eight bytes of both names inline, so comparisons rarely have to
+// follow the views into the pool.
+//
+// Queries (case-insensitive):
+//   "Lee, A"      last name Lee, first name starting with A ("Lee," alone: any first name)
+//   "Ann Lee"     first name Ann and last name Lee exactly
+//   "Le"          last name or first name starting with Le
+// Not synchronized: the owner guards it.
+class PatronNameIndex {
+public:
+    struct Entry {
+        int patronID;
+        std::string_view name;
+    };
+
+    void Add(int patronID, std::string_view name);
+    void Remove(int patronID, std::string_view name);
+
+    // Indexes many patrons at once: the keys are sorted first and inserted in order,
+    // which is several times faster than one Add per patron on a large load
+    void AddBulk(const std::vector<Entry>& entries);
+
+    // Patron IDs matching a query (see above), up to maxResults, in last-name order
+    std::vector<int> Search(std::string_view query, std::size_t maxResults) const;
+
+    // Patron IDs whose full name is exactly this (case-insensitive), lowest ID first
+    std::vector<int> FindExact(std::string_view name, std::size_t maxResults) const;
+
+    void Clear();
+
+    // Case-folded first and last name of a full name
+    static void SplitName(std::string_view name, std::string& first, std::string& last);
+
+private:
+    struct Key {
+        Key(std::string_view major, std::string_view minor, int patronID)
+            : majorHead(Head(major)), minorHead(Head(minor)), major(major), minor(minor), patronID(patronID) {}
+
+        // First eight bytes, big-endian and zero-padded: orders like the strings do
+        // whenever they differ
+        static std::uint64_t Head(std::string_view s) {
+            std::uint64_t head = 0;
+            for (std::size_t i = 0; i < 8; ++i) head = (head << 8) | (i < s.size() ? static_cast<unsigned char>(s[i]) : 0u);
+            return head;
+        }
+
+        // Interned names are equal exactly when they are the same view
+        static bool Same(std::string_view a, std::string_view b) {
+            return (a.data() == b.data() && a.size() == b.size()) || a == b;
+        }
+
+        bool operator<(const Key& other) const {
+            if (majorHead != other.majorHead) return majorHead < other.majorHead;
+            if (!Same(major, other.major)) return major < other.major;
+            if (minorHead != other.minorHead) return minorHead < other.minorHead;
+            if (!Same(minor, other.minor)) return minor < other.minor;
+            return patronID < other.patronID;
+        }
+
+        std::uint64_t majorHead;
+        std::uint64_t minorHead;
+        std::string_view major; // last name in byLast, first name in byFirst
+        std::string_view minor;
+        int patronID;
+    };
+
+    // Appends the IDs of keys whose major is major and whose minor is minor (or starts
+    // with it), or with majorPrefix, whose major starts with major (any minor); stops at
+    // maxResults and skips IDs already in out
+    static void Scan(const std::multiset<Key>& keys, std::string_view major, bool majorPrefix,
+                     std::string_view minor, bool minorPrefix, std::size_t maxResults, std::vector<int>& out);
+
+    // Multisets, so a rename that keeps the folded name can add the new version's key
+    // before the old one is removed
+    std::multiset<Key> byLast;
+    std::multiset<Key> byFirst;
+};
+
+#endif // PATRONNAMEINDEX_H
@@ -4,8 +4,12 @@
 #include <limits>
 #include <algorithm>
 #include <cctype>
+#include <mutex>
+#include <shared_mutex>
 #include "PatronsCollection.h"
 #include "Patron.h"
+#include "Journal.h"
+#include "ReportWriter.h"
 
 using namespace std;
 
@@ -28,57 +32,84 @@ int getIntInput(const string& prompt);
 
 // Definition of static member declared in header
 // Start IDs at 1 so the first patron receives ID 1 (no zero ID)
-int PatronsCollection::nextPatronID = 1;
+std::atomic<int> PatronsCollection::nextPatronID{ 1 };
 
 // Helper input functions
 
 // Edit a patron's details
 void PatronsCollection::EditPatron() {
     cout << "\n--- Edit Patron ---\n";
-    Patron* patron = PromptForSearchMechanism();
-    if (!patron) {
-        cout << "Patron not found.\n";
-        return;
+    const int id = PromptForSearchMechanism();
+    float currentFine;
+    {
+        Epoch::ReadGuard guard; // keeps the looked-up patron alive while it is read
+        const Patron* patron = FindPatronByID(id);
+        if (!patron) {
+            cout << "Patron not found.\n";
+            return;
+        }
+        currentFine = patron->getFineBalance();
     }
+
+    // Both answers are read before the record is locked, so a terminal left at a prompt
+    // does not hold up circulation on the patrons sharing its lock stripe
     string newName = getStringInput("Enter new full name (leave blank to keep current): ");
-    if (!newName.empty()) {
-        patron->setName(newName);
-    }
     // Optionally edit fines
-    cout << "Current fine balance: $" << patron->getFineBalance() << "\n";
+    cout << "Current fine balance: $" << currentFine << "\n";
     cout << "Enter new fine balance (or press Enter to keep current): ";
     string line;
     getline(cin, line);
+    bool fineChanged = false;
+    float newFine = 0.0f;
     if (!line.empty()) {
         try {
-            float f = stof(line);
-            patron->setFineBalance(f);
+            newFine = stof(line);
+            fineChanged = true;
         } catch (...) {
             cout << "Invalid fine value entered; keeping current.\n";
         }
     }
+
+    // Look the patron up again under its lock: it may have changed or gone meanwhile
+    lock_guard<mutex> record(RecordLock(id));
+    Patron* patron = FindPatronByID(id);
+    if (!patron) {
+        cout << "Patron not found.\n";
+        return;
+    }
+    if (!newName.empty()) {
+        unique_lock<shared_mutex> lock(patronsMutex);
+        patron = Rename(patron, newName);
+    }
+    if (fineChanged) patron->setFineBalance(newFine);
+    LogPatron(*patron);
     cout << "Patron updated.\n";
 }
 
 // Delete a patron
 void PatronsCollection::DeletePatron() {
     cout << "\n--- Delete Patron ---\n";
-    Patron* patron = PromptForSearchMechanism();
-    if (!patron) {
+    const int id = PromptForSearchMechanism();
+    lock_guard<mutex> record(RecordLock(id));
+    unique_lock<shared_mutex> lock(patronsMutex);
+    PatronRef ref;
+    if (!RefFor(id, ref)) {
         cout << "Patron not found.\n";
         return;
     }
-    auto it = std::find(patronsList.begin(), patronsList.end(), patron);
-    if (it != patronsList.end()) {
-        delete *it;
-        patronsList.erase(it);
-        cout << "Patron deleted.\n";
+    if (journal) {
+        journal->LogPatronDeleted(id);
+        journal->Commit();
     }
+    RetirePatron(ref);
+    cout << "Patron deleted.\n";
 }
 
 // Print a single patron's details
 void PatronsCollection::PrintPatron() {
-    Patron* patron = PromptForSearchMechanism();
+    const int id = PromptForSearchMechanism();
+    lock_guard<mutex> record(RecordLock(id));
+    Patron* patron = FindPatronByID(id);
     if (!patron) {
         cout << "Patron not found.\n";
         return;
@@ -89,17 +120,41 @@ void PatronsCollection::PrintPatron() {
 
 // Pay fine for a patron
 void PatronsCollection::PayFine() {
-    Patron* patron = PromptForSearchMechanism();
-    if (!patron) {
+    const int id = PromptForSearchMechanism();
+    {
+        Epoch::ReadGuard guard; // keeps the looked-up patron alive while it is read
+        const Patron* patron = FindPatronByID(id);
+        if (!patron) {
+            cout << "Patron not found.\n";
+            return;
+        }
+        cout << "Current fine balance: $" << patron->getFineBalance() << "\n";
+    }
+    float amount = getNumericInput<float>("Enter payment amount: ");
+    ResultCode result = PayFine(id, amount);
+    if (result == ResultCode::PATRON_NOT_FOUND) {
         cout << "Patron not found.\n";
         return;
     }
-    cout << "Current fine balance: $" << patron->getFineBalance() << "\n";
-    float amount = getNumericInput<float>("Enter payment amount: ");
+    if (result != ResultCode::OK) {
+        cout << "Payment amount cannot be negative.\n";
+        return;
+    }
+    lock_guard<mutex> record(RecordLock(id));
+    const Patron* patron = FindPatronByID(id);
+    if (patron) cout << "Payment applied. New balance: $" << patron->getFineBalance() << "\n";
+}
+
+ResultCode PatronsCollection::PayFine(int patronID, float amount) {
+    if (amount < 0) return ResultCode::INVALID_FIELD;
+    lock_guard<mutex> record(RecordLock(patronID));
+    Patron* patron = FindPatronByID(patronID);
+    if (!patron) return ResultCode::PATRON_NOT_FOUND;
     float newBal = patron->getFineBalance() - amount;
     if (newBal < 0) newBal = 0;
     patron->setFineBalance(newBal);
-    cout << "Payment applied. New balance: $" << patron->getFineBalance() << "\n";
+    LogPatron(*patron);
+    return ResultCode::OK;
 }
 string getStringInput(const string& prompt) {
     cout << prompt;
@@ -124,18 +179,10 @@ int getIntInput(const string& prompt) {
 void PatronsCollection::AddPatron() {
     cout << "\n--- Add a New Patron ---\n";
     // Get and validate first and last name: only letters allowed (a-z, A-Z)
-    auto isAlphaOnly = [](const string& s) {
-        if (s.empty()) return false;
-        for (unsigned char ch : s) {
-            if (!std::isalpha(ch)) return false;
-        }
-        return true;
-    };
-
     string firstName;
     while (true) {
         firstName = getStringInput("Enter patron's first name: ");
-        if (!isAlphaOnly(firstName)) {
+        if (!IsValidNamePart(firstName)) {
             cout << "Please enter letters only (a-z or A-Z) for the first name." << endl;
             continue;
         }
@@ -145,36 +192,154 @@ void PatronsCollection::AddPatron() {
     string lastName;
     while (true) {
         lastName = getStringInput("Enter patron's last name: ");
-        if (!isAlphaOnly(lastName)) {
+        if (!IsValidNamePart(lastName)) {
             cout << "Please enter letters only (a-z or A-Z) for the last name." << endl;
             continue;
         }
         break;
     }
 
-    // Assign a unique incremental ID and create the patron
-    int ID = nextPatronID++;
-    string fullName = firstName + " " + lastName;
-
-    Patron* patron = new Patron(fullName, ID);
-    patronsList.push_back(patron);
+    int ID = 0;
+    AddPatron(firstName, lastName, &ID);
 
     // Print first name, last name and assigned ID, then confirmation message
     cout << "First Name: " << firstName << ", Last Name: " << lastName << ", Assigned ID: " << ID << "\n";
     cout << "Patron added successfully." << "\n";
 }
 
+Patron* PatronsCollection::InsertPatron(const string& name, int id) {
+    unique_lock<shared_mutex> lock(patronsMutex);
+    return IndexPatron(patronsList.Emplace(name, id));
+}
+
+void PatronsCollection::InsertPatronsBulk(vector<Patron>& newPatrons) {
+    unique_lock<shared_mutex> lock(patronsMutex);
+    const size_t total = patronsList.Size() + newPatrons.size();
+    patronsList.Reserve(total);
+    patronsByID.Reserve(total);
+    vector<PatronNameIndex::Entry> entries;
+    entries.reserve(newPatrons.size());
+    for (Patron& added : newPatrons) {
+        SlabHandle handle = patronsList.Emplace(std::move(added));
+        Patron* patron = patronsList.Get(handle);
+        if (!patronsByID.Set(patron->getPatronID(), patron, handle)) {
+            patronsList.Erase(handle);
+            continue;
+        }
+        entries.push_back({ patron->getPatronID(), patron->getName() });
+    }
+    unique_lock<shared_mutex> names(nameMutex);
+    nameIndex.AddBulk(entries);
+}
+
+void PatronsCollection::Reserve(size_t count) {
+    unique_lock<shared_mutex> lock(patronsMutex);
+    patronsList.Reserve(count);
+    patronsByID.Reserve(count);
+}
+
+Patron* PatronsCollection::UpsertPatron(const string& name, int id) {
+    unique_lock<shared_mutex> lock(patronsMutex);
+    Patron* patron = LookupID(id);
+    if (!patron) return IndexPatron(patronsList.Emplace(name, id));
+    return patron->getName() == name ? patron : Rename(patron, name);
+}
+
+bool PatronsCollection::RemovePatron(int id) {
+    unique_lock<shared_mutex> lock(patronsMutex);
+    PatronRef ref;
+    if (!RefFor(id, ref)) return false;
+    RetirePatron(ref);
+    return true;
+}
+
+bool PatronsCollection::RefFor(int id, PatronRef& ref) const {
+    return patronsByID.Get(id, ref.patron, ref.handle);
+}
+
+Patron* PatronsCollection::IndexPatron(SlabHandle handle) {
+    Patron* patron = patronsList.Get(handle);
+    if (!patronsByID.Set(patron->getPatronID(), patron, handle)) { // IDs start at 1
+        patronsList.Erase(handle);
+        return nullptr;
+    }
+    unique_lock<shared_mutex> names(nameMutex);
+    nameIndex.Add(patron->getPatronID(), patron->getName());
+    return patron;
+}
+
+void PatronsCollection::UnindexPatron(const PatronRef& ref) {
+    if (patronsByID.Find(ref.patron->getPatronID()) == ref.patron) patronsByID.Erase(ref.patron->getPatronID());
+    unique_lock<shared_mutex> names(nameMutex);
+    nameIndex.Remove(ref.patron->getPatronID(), ref.patron->getName());
+}
+
+// The new version is indexed before the old one is unindexed, so a concurrent lookup
+// by ID always finds one of the two
+Patron* PatronsCollection::Rename(Patron* patron, const string& name) {
+    PatronRef old;
+    RefFor(patron->getPatronID(), old);
+    Patron renamed(*patron);
+    renamed.setName(name);
+    Patron* published = IndexPatron(patronsList.Emplace(std::move(renamed)));
+    RetirePatron(old);
+    return published;
+}
+
+void PatronsCollection::RetirePatron(const PatronRef& ref) {
+    UnindexPatron(ref);
+    SlabHandle handle = ref.handle;
+    retiredPatrons.Retire([this, handle] { patronsList.Erase(handle); });
+}
+
+void PatronsCollection::SetJournal(Journal* j) { journal = j; }
+
+void PatronsCollection::LogPatron(const Patron& patron) {
+    if (!journal) return;
+    journal->LogPatron(patron);
+    journal->Commit();
+}
+
+int PatronsCollection::GetNextPatronID() { return nextPatronID; }
+void PatronsCollection::SetNextPatronID(int id) { nextPatronID = id; }
+
+ResultCode PatronsCollection::AddPatron(const string& firstName, const string& lastName, int* assignedID) {
+    if (!IsValidNamePart(firstName) || !IsValidNamePart(lastName)) return ResultCode::INVALID_FIELD;
+
+    // Assign a unique incremental ID and create the patron
+    int ID = nextPatronID++;
+    lock_guard<mutex> record(RecordLock(ID));
+    Patron* patron;
+    {
+        unique_lock<shared_mutex> lock(patronsMutex);
+        patron = IndexPatron(patronsList.Emplace(firstName + " " + lastName, ID));
+    }
+    LogPatron(*patron);
+    if (assignedID) *assignedID = ID;
+    return ResultCode::OK;
+}
+
+bool PatronsCollection::IsValidNamePart(string_view s) {
+    if (s.empty()) return false;
+    for (unsigned char ch : s) {
+        if (!std::isalpha(ch)) return false;
+    }
+    return true;
+}
+
 // Search Options
-Patron* PatronsCollection::PromptForSearchMechanism() {
+int PatronsCollection::PromptForSearchMechanism() {
     while (true) {
         string method = getStringInput("Search by name or ID? (name/id): ");
         if (method == "name") {
-            string name = getStringInput("Enter the patron's full name: ");
-            return FindPatronByName(name);
+            string query = getStringInput("Enter the patron's name (First Last, Last, F, or the start of a name): ");
+            vector<int> ids = SearchPatrons(query, 10);
+            if (ids.size() == 1) return FindPatronByID(ids.front()) ? ids.front() : 0;
+            return PromptForPick(ids);
         }
         else if (method == "id") {
             int id = getIntInput("Enter the patron's ID: ");
-            return FindPatronByID(id);
+            return FindPatronByID(id) ? id : 0;
         }
         else {
             cout << "Invalid option. Please type 'name' or 'id'.\n";
@@ -182,37 +347,79 @@ Patron* PatronsCollection::PromptForSearchMechanism() {
     }
 }
 
-Patron* PatronsCollection::FindPatronByName(string name) {
-    for (auto* patron : patronsList) {
-        if (patron->getName() == name)
-            return patron;
+int PatronsCollection::PromptForPick(const vector<int>& ids) {
+    vector<int> listed;
+    {
+        Epoch::ReadGuard guard;
+        for (int id : ids) {
+            const Patron* patron = LookupID(id);
+            if (!patron) continue; // deleted since the search
+            listed.push_back(id);
+            cout << listed.size() << ". " << patron->getName() << " (ID " << id << ")\n";
+        }
+    }
+    if (listed.empty()) return 0;
+
+    string line;
+    while (true) {
+        cout << "Select a patron (1-" << listed.size() << ", 0 for none): ";
+        if (!getline(cin, line)) return 0;
+        try {
+            size_t pick = static_cast<size_t>(stoul(line));
+            if (pick == 0) return 0;
+            if (pick <= listed.size()) return listed[pick - 1];
+        } catch (...) {}
+        cout << "Please enter a number from the list.\n";
     }
-    return nullptr;
 }
 
-Patron* PatronsCollection::FindPatronByID(int id) {
-    for (auto* patron : patronsList) {
-        if (patron->getPatronID() == id)
-            return patron;
+vector<int> PatronsCollection::SearchPatrons(string_view query, size_t maxResults) const {
+    shared_lock<shared_mutex> names(nameMutex);
+    return nameIndex.Search(query, maxResults);
+}
+
+// By ID the lookup is a direct slot load with no lock; by name it goes through the
+// sorted name index. When several patrons share a name the one added first is returned.
+Patron* PatronsCollection::FindPatronByName(string_view name) {
+    vector<int> ids;
+    {
+        shared_lock<shared_mutex> names(nameMutex);
+        ids = nameIndex.FindExact(name, 1);
     }
-    return nullptr;
+    return ids.empty() ? nullptr : FindPatronByID(ids.front());
+}
+
+Patron* PatronsCollection::FindPatronByID(int id) {
+    Epoch::ReadGuard guard;
+    return LookupID(id);
+}
+
+Patron* PatronsCollection::LookupID(int id) const {
+    return patronsByID.Find(id);
 }
 
 // Print All
 void PatronsCollection::PrintAllPatrons() const {
-    cout << "\n--- List of All Patrons ---\n";
-    if (patronsList.empty()) {
-        cout << "There are no patrons." << endl;
+    ReportWriter out;
+    PrintAllPatrons(out);
+}
+
+void PatronsCollection::PrintAllPatrons(ReportWriter& out) const {
+    out << "\n--- List of All Patrons ---\n";
+    shared_lock<shared_mutex> lock(patronsMutex);
+    if (patronsByID.Size() == 0) {
+        out << "There are no patrons.\n";
         return;
     }
 
-    for (const auto* patron : patronsList) {
-        cout << "ID: " << patron->getPatronID()
-            << ", Name: " << patron->getName()
-            << ", Fines: $" << patron->getFineBalance()
-            << ", Books Checked Out: " << patron->getNumBooks()
-            << endl;
-    }
+    patronsList.ForEach([this, &out](SlabHandle, const Patron& patron) {
+        if (!IsCurrent(patron)) return;
+        out << "ID: " << patron.getPatronID()
+            << ", Name: " << patron.getName()
+            << ", Fines: $" << patron.getFineBalance()
+            << ", Books Checked Out: " << patron.getNumBooks()
+            << '\n';
+    });
 }
 
 // -----------------------------
@@ -220,10 +427,13 @@ void PatronsCollection::PrintAllPatrons() const {
 // -----------------------------
 void PatronsCollection::CheckoutBook() {
     cout << "\n--- Checkout a Book ---\n";
-    Patron* patron = PromptForSearchMechanism();
+    const int id = PromptForSearchMechanism();
+    lock_guard<mutex> record(RecordLock(id));
+    Patron* patron = FindPatronByID(id);
 
     if (patron != nullptr) {
         if (patron->checkoutBook()) {
+            LogPatron(*patron);
             cout << "Book checked out successfully.\n";
         }
         else {
@@ -240,10 +450,13 @@ void PatronsCollection::CheckoutBook() {
 
 void PatronsCollection::ReturnBook() {
     cout << "\n--- Return a Book ---\n";
-    Patron* patron = PromptForSearchMechanism();
+    const int id = PromptForSearchMechanism();
+    lock_guard<mutex> record(RecordLock(id));
+    Patron* patron = FindPatronByID(id);
 
     if (patron != nullptr) {
         patron->returnBook();
+        LogPatron(*patron);
         cout << "Book returned successfully." << endl;
         cout << "You still have " << patron->getNumBooks() << " book(s) checked out." << endl;
     }
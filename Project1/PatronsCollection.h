@@ -2,8 +2,21 @@
 #define PATRONSCOLLECTION_H
 
 #include <string>
+#include <string_view>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
 #include <vector>
 #include "Patron.h"
+#include "SlabStore.h"
+#include "ResultCode.h"
+#include "LockStripes.h"
+#include "Epoch.h"
+#include "DenseIdTable.h"
+#include "PatronNameIndex.h"
+
+class Journal;
+class ReportWriter;
 
 // The PatronsCollection class manages a collection of Patron objects.
 // It provides functionalities to add, edit, delete, and search for patrons,
@@ -19,17 +32,19 @@ public:
     // Deletes a patron from the collection
     void DeletePatron();
 
-    // Prompts the user for a search mechanism (by name or ID) and returns the corresponding Patron object
-    Patron* PromptForSearchMechanism();
+    // Prompts the user for a search mechanism (by name or ID) and returns the ID of the patron
+    // found, or 0. Callers resolve the ID under a ReadGuard or record lock when they need the record.
+    int PromptForSearchMechanism();
 
-    // Finds and returns a Patron object by name. Returns nullptr if not found.
-    Patron* FindPatronByName(std::string name);
+    // Finds and returns a Patron object by full name, ignoring case. Returns nullptr if not found.
+    Patron* FindPatronByName(std::string_view name);
 
     // Finds and returns a Patron object by ID. Returns nullptr if not found.
     Patron* FindPatronByID(int id);
 
-    // Prints details for all patrons in the collection
+    // Prints details for all patrons in the collection, to standard output or to out
     void PrintAllPatrons() const;
+    void PrintAllPatrons(ReportWriter& out) const;
 
     // Prints details of a specific patron
     void PrintPatron();
@@ -41,11 +56,113 @@ public:
     void CheckoutBook();
     void ReturnBook();
 
+    // Core API (no console I/O). Same validation as the prompts; changes are journaled.
+    // AddPatron stores the new patron's ID in assignedID when it is not null.
+    ResultCode AddPatron(const std::string& firstName, const std::string& lastName, int* assignedID = nullptr);
+    ResultCode PayFine(int patronID, float amount);
+
+    // Name search, case-insensitive: "Last, F" (last name and first initial or prefix),
+    // "First Last" (exact) or a single word (start of a first or last name). Returns up to
+    // maxResults patron IDs in last-name order; see PatronNameIndex.
+    std::vector<int> SearchPatrons(std::string_view query, std::size_t maxResults = 20) const;
+
+    // Validation rule for first and last names: letters only
+    static bool IsValidNamePart(std::string_view s);
+
+    // Concurrency: FindPatronByID takes no lock (see Epoch.h) and name lookups hold
+    // nameMutex shared; adding, deleting and renaming hold patronsMutex exclusively. A rename publishes a new copy of
+    // the record, so a looked-up Patron* stays valid only inside an Epoch::ReadGuard or while
+    // holding RecordLock(id), which keeps the patron from being renamed or deleted. Fines and
+    // the loan count change in place under the record lock.
+    // Take record locks before patronsMutex, never the other way round.
+    std::mutex& RecordLock(int patronID) const { return recordLocks.For(patronID); }
+
+    // Programmatic access (no console I/O), used by persistence.
+    // InsertPatron stores a patron under an existing ID and returns it (nullptr for an ID
+    // below 1, which AddPatron never hands out).
+    Patron* InsertPatron(const std::string& name, int id);
+    void Reserve(std::size_t count);
+    std::size_t Count() const { return patronsByID.Size(); }
+
+    // Bulk load: stores patrons whose IDs are new and distinct (skipping IDs below 1) and
+    // indexes their names in one sorted pass. newPatrons is moved from.
+    void InsertPatronsBulk(std::vector<Patron>& newPatrons);
+
+    // Journal replay: returns the patron with this ID (creating it if missing) with the
+    // given name (nullptr for an ID below 1), or drops a patron
+    Patron* UpsertPatron(const std::string& name, int id);
+    bool RemovePatron(int id);
+
+    // Mutations made through the interactive functions are logged here (may be nullptr)
+    void SetJournal(Journal* journal);
+
+    template <typename Fn>
+    void ForEachPatron(Fn fn) const {
+        std::shared_lock<std::shared_mutex> lock(patronsMutex);
+        patronsList.ForEach([&](SlabHandle, const Patron& patron) {
+            if (IsCurrent(patron)) fn(patron);
+        });
+    }
+
+    // Next ID AddPatron will hand out
+    static int GetNextPatronID();
+    static void SetNextPatronID(int id);
+
 private:
-    std::vector<Patron*> patronsList; // A vector to store pointers to Patron objects
+    // Lists patrons by ID and lets the user pick one (0 if none was picked)
+    int PromptForPick(const std::vector<int>& patronIDs);
+
+    // Logs a patron's current state as one journal transaction (caller holds its record lock)
+    void LogPatron(const Patron& patron);
+
+    // A stored patron: the pointer readers use and the slot that owns it
+    struct PatronRef {
+        Patron* patron;
+        SlabHandle handle;
+    };
+
+    // The stored patron with this ID (caller holds patronsMutex exclusively); false if none
+    bool RefFor(int id, PatronRef& ref) const;
+
+    // Keep the lookup indexes below in sync with patronsList (caller holds patronsMutex exclusively)
+    Patron* IndexPatron(SlabHandle handle);
+    void UnindexPatron(const PatronRef& ref);
+
+    // Publishes a renamed copy of a patron and retires the old one (caller holds
+    // patronsMutex exclusively and the patron's record lock); returns the new version
+    Patron* Rename(Patron* patron, const std::string& name);
+
+    // Drops a patron from the indexes; its slot is freed once no reader can see it
+    void RetirePatron(const PatronRef& ref);
+
+    // False for versions that were replaced or deleted but not yet reclaimed
+    bool IsCurrent(const Patron& patron) const {
+        return patronsByID.Find(patron.getPatronID()) == &patron;
+    }
+
+    // Lookup for callers already holding patronsMutex or a ReadGuard
+    Patron* LookupID(int id) const;
+
+    SlabStore<Patron> patronsList; // Owns the Patron records, stored contiguously
+    Journal* journal = nullptr;
+
+    // ID index over patronsList, readable without patronsMutex
+    DenseIdTable<Patron, SlabHandle> patronsByID{ 1 }; // patron ID -> patron (and its slot)
+
+    // Names -> patron IDs. Lookups hold nameMutex shared; IndexPatron and UnindexPatron
+    // take it exclusively after patronsMutex.
+    PatronNameIndex nameIndex;
+    mutable std::shared_mutex nameMutex;
+
+    // Renamed and deleted records waiting for readers to move on; declared after
+    // patronsList so it is destroyed (and its pending slots erased) first
+    RetireList retiredPatrons;
+
+    mutable std::shared_mutex patronsMutex; // serializes writers to patronsList and the indexes
+    mutable LockStripes recordLocks;        // per-patron locks, by patron ID
 
     // Unique incremental ID generator for patrons (ensures stable unique IDs even after deletions)
-    static int nextPatronID;
+    static std::atomic<int> nextPatronID;
 };
 
 #endif // PATRONSCOLLECTION_H
@@ -0,0 +1,131 @@
+#ifndef RCUHASHMAP_H
+#define RCUHASHMAP_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include "Epoch.h"
+
+// Hash map whose readers never block: one writer at a time (serialized by the owner),
+// any number of concurrent readers inside an Epoch::ReadGuard.
+//
+// Nodes are immutable once published. Set replaces a node, Erase unlinks one, and
+// growing the table builds a new bucket array; in every case the new state is
+// published with a single pointer store and the old nodes go to a RetireList, so a
+// reader walking a chain always sees either the old or the new version.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class RcuHashMap {
+public:
+    RcuHashMap() : table(new Table(MIN_BUCKETS)) {}
+    ~RcuHashMap() { DeleteTable(table.load(std::memory_order_relaxed)); }
+    RcuHashMap(const RcuHashMap&) = delete;
+    RcuHashMap& operator=(const RcuHashMap&) = delete;
+
+    // Reader (inside a ReadGuard) or writer: the value for key, or nullptr. A reader's
+    // pointer stays valid until its guard ends; a writer's until its next Set/Erase.
+    const V* Find(const K& key) const {
+        const Table* current = table.load(std::memory_order_acquire);
+        const Node* node = current->buckets[hasher(key) & current->mask].load(std::memory_order_acquire);
+        for (; node; node = node->next.load(std::memory_order_acquire)) {
+            if (node->key == key) return &node->value;
+        }
+        return nullptr;
+    }
+
+    // Writer: inserts or replaces the value for key
+    void Set(const K& key, V value) {
+        Table* current = table.load(std::memory_order_relaxed);
+        std::atomic<Node*>* link = &current->buckets[hasher(key) & current->mask];
+        for (Node* node = link->load(std::memory_order_relaxed); node; node = node->next.load(std::memory_order_relaxed)) {
+            if (node->key == key) {
+                Node* replacement = new Node(key, std::move(value), node->next.load(std::memory_order_relaxed));
+                link->store(replacement, std::memory_order_release);
+                retired.Retire([node] { delete node; });
+                return;
+            }
+            link = &node->next;
+        }
+        std::atomic<Node*>& head = current->buckets[hasher(key) & current->mask];
+        head.store(new Node(key, std::move(value), head.load(std::memory_order_relaxed)), std::memory_order_release);
+        if (++count > current->mask + 1) Rehash((current->mask + 1) * 2);
+    }
+
+    // Writer: removes key; returns false if it was not present
+    bool Erase(const K& key) {
+        Table* current = table.load(std::memory_order_relaxed);
+        std::atomic<Node*>* link = &current->buckets[hasher(key) & current->mask];
+        for (Node* node = link->load(std::memory_order_relaxed); node; node = node->next.load(std::memory_order_relaxed)) {
+            if (node->key == key) {
+                link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+                retired.Retire([node] { delete node; });
+                --count;
+                return true;
+            }
+            link = &node->next;
+        }
+        return false;
+    }
+
+    // Writer: sizes the bucket array for count entries up front
+    void Reserve(std::size_t expected) {
+        std::size_t buckets = table.load(std::memory_order_relaxed)->mask + 1;
+        if (expected <= buckets) return;
+        while (buckets < expected) buckets *= 2;
+        Rehash(buckets);
+    }
+
+    std::size_t Size() const { return count.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t MIN_BUCKETS = 16;
+
+    struct Node {
+        Node(const K& key, V value, Node* next) : key(key), value(std::move(value)), next(next) {}
+        const K key;
+        const V value;
+        std::atomic<Node*> next;
+    };
+
+    struct Table {
+        explicit Table(std::size_t bucketCount) : mask(bucketCount - 1), buckets(new std::atomic<Node*>[bucketCount]) {
+            for (std::size_t i = 0; i < bucketCount; ++i) buckets[i].store(nullptr, std::memory_order_relaxed);
+        }
+        std::size_t mask;
+        std::unique_ptr<std::atomic<Node*>[]> buckets;
+    };
+
+    static void DeleteTable(Table* doomed) {
+        for (std::size_t i = 0; i <= doomed->mask; ++i) {
+            Node* node = doomed->buckets[i].load(std::memory_order_relaxed);
+            while (node) {
+                Node* next = node->next.load(std::memory_order_relaxed);
+                delete node;
+                node = next;
+            }
+        }
+        delete doomed;
+    }
+
+    // Copies every node into a new bucket array, publishes it, and retires the old one whole
+    void Rehash(std::size_t bucketCount) {
+        Table* old = table.load(std::memory_order_relaxed);
+        Table* grown = new Table(bucketCount);
+        for (std::size_t i = 0; i <= old->mask; ++i) {
+            for (Node* node = old->buckets[i].load(std::memory_order_relaxed); node; node = node->next.load(std::memory_order_relaxed)) {
+                std::atomic<Node*>& head = grown->buckets[hasher(node->key) & grown->mask];
+                head.store(new Node(node->key, node->value, head.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+            }
+        }
+        table.store(grown, std::memory_order_release);
+        retired.Retire([old] { DeleteTable(old); });
+    }
+
+    std::atomic<Table*> table;
+    std::atomic<std::size_t> count{0};
+    Hash hasher;
+    RetireList retired; // only holds unlinked nodes and replaced tables, never the live table
+};
+
+#endif // RCUHASHMAP_H
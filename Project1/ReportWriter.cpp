@@ -0,0 +1,154 @@
+#include "ReportWriter.h"
+#include <array>
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// helpers (file-local)
+namespace {
+
+// Local time only changes offset on quarter-hour boundaries (every zone offset and DST
+// switch is a multiple of 15 minutes), so within one UTC-aligned 15-minute slot the text
+// is a fixed "MM-DD-YYYY HH:" prefix plus minutes and seconds counted from the slot start.
+// A small direct-mapped cache of slots keeps localtime/strftime off the per-row path.
+const std::int64_t SLOT_SECONDS = 15 * 60;
+const std::size_t CACHE_SLOTS = 1024;
+
+struct DateSlot {
+    std::int64_t slot = INT64_MIN;
+    char prefix[14];  // "MM-DD-YYYY HH:"
+    int minute = 0;   // local minute at the slot start
+};
+
+thread_local std::array<DateSlot, CACHE_SLOTS> dateCache;
+
+const DateSlot& dateSlotFor(std::int64_t epoch) {
+    std::int64_t slot = epoch / SLOT_SECONDS;
+    if (epoch % SLOT_SECONDS < 0) --slot;
+    DateSlot& cached = dateCache[static_cast<std::size_t>(slot) % CACHE_SLOTS];
+    if (cached.slot == slot) return cached;
+
+    std::time_t t = static_cast<std::time_t>(slot * SLOT_SECONDS);
+    std::tm tm;
+#if defined(_MSC_VER)
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    char text[32];
+    std::strftime(text, sizeof(text), "%m-%d-%Y %H:", &tm);
+    std::memcpy(cached.prefix, text, sizeof(cached.prefix));
+    cached.minute = tm.tm_min;
+    cached.slot = slot;
+    return cached;
+}
+
+void twoDigits(char* out, int value) {
+    out[0] = static_cast<char>('0' + value / 10);
+    out[1] = static_cast<char>('0' + value % 10);
+}
+
+} // namespace
+
+ReportWriter::ReportWriter()
+    : buffer(BUFFER_SIZE, '\0'), used(0), file(stdout), ownsFile(false), fd(-1), ok(true) {}
+
+ReportWriter::ReportWriter(const std::string& path)
+    : buffer(BUFFER_SIZE, '\0'), used(0), file(std::fopen(path.c_str(), "wb")), ownsFile(true), fd(-1), ok(file != nullptr) {}
+
+ReportWriter::ReportWriter(int fd)
+    : buffer(BUFFER_SIZE, '\0'), used(0), file(nullptr), ownsFile(false), fd(fd), ok(fd >= 0) {}
+
+ReportWriter::~ReportWriter() {
+    Flush();
+    if (ownsFile && file) std::fclose(file);
+}
+
+bool ReportWriter::IsOpen() const {
+    return file != nullptr || fd >= 0;
+}
+
+ReportWriter& ReportWriter::operator<<(std::string_view text) {
+    if (text.size() > BUFFER_SIZE / 2) {
+        Flush();
+        WriteOut(text.data(), text.size());
+        return *this;
+    }
+    Reserve(text.size());
+    std::memcpy(&buffer[used], text.data(), text.size());
+    used += text.size();
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(char c) {
+    Reserve(1);
+    buffer[used++] = c;
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(float value) {
+    Reserve(32);
+    used = std::to_chars(&buffer[used], buffer.data() + BUFFER_SIZE, value, std::chars_format::general, 6).ptr - buffer.data();
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(Fixed number) {
+    Reserve(64);
+    auto result = std::to_chars(&buffer[used], buffer.data() + BUFFER_SIZE, number.value, std::chars_format::fixed,
+                                number.decimals);
+    if (result.ec == std::errc()) used = result.ptr - buffer.data();
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(DateTime date) {
+    const DateSlot& slot = dateSlotFor(date.epoch);
+    std::int64_t offset = date.epoch - slot.slot * SLOT_SECONDS;
+    Reserve(sizeof(slot.prefix) + 5);
+    char* out = &buffer[used];
+    std::memcpy(out, slot.prefix, sizeof(slot.prefix));
+    twoDigits(out + sizeof(slot.prefix), slot.minute + static_cast<int>(offset / 60));
+    out[sizeof(slot.prefix) + 2] = ':';
+    twoDigits(out + sizeof(slot.prefix) + 3, static_cast<int>(offset % 60));
+    used += sizeof(slot.prefix) + 5;
+    return *this;
+}
+
+void ReportWriter::AppendInteger(long long value) {
+    used = std::to_chars(&buffer[used], buffer.data() + BUFFER_SIZE, value).ptr - buffer.data();
+}
+
+void ReportWriter::Flush() {
+    if (used == 0) return;
+    WriteOut(buffer.data(), used);
+    used = 0;
+}
+
+void ReportWriter::WriteOut(const char* data, std::size_t size) {
+    if (!ok) return;
+    if (file) {
+        if (file == stdout) std::cout.flush(); // keep order with earlier console output
+        ok = std::fwrite(data, 1, size, file) == size && std::fflush(file) == 0;
+        return;
+    }
+    while (size > 0) {
+#if defined(_WIN32)
+        int chunk = size > (1u << 30) ? (1 << 30) : static_cast<int>(size);
+        int written = _write(fd, data, chunk);
+#else
+        ssize_t written = ::write(fd, data, size);
+#endif
+        if (written <= 0) {
+            ok = false;
+            return;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef REPORTWRITER_H
+#define REPORTWRITER_H
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+// Buffered text output for large listings. Records are formatted into one reusable 1 MB
+// buffer (numbers with std::to_chars, dates through a small cache of local-time prefixes)
+// and written out a buffer at a time, so a listing costs a handful of write calls rather
+// than a flush per line. The target is standard output, a file, or an open descriptor.
+// Whatever is buffered is written on Flush() and when the writer is destroyed.
+class ReportWriter {
+public:
+    // Fixed-point number with the given number of decimals, e.g. a cost as 9.50
+    struct Fixed {
+        double value;
+        int decimals;
+    };
+
+    // Local time as MM-DD-YYYY HH:MM:SS, the format of the console listings
+    struct DateTime {
+        std::int64_t epoch;
+    };
+
+    ReportWriter();                              // standard output
+    explicit ReportWriter(const std::string& path); // creates or truncates the file
+    explicit ReportWriter(int fd);               // the descriptor is left open
+    ~ReportWriter();
+    ReportWriter(const ReportWriter&) = delete;
+    ReportWriter& operator=(const ReportWriter&) = delete;
+
+    bool IsOpen() const;
+    bool Good() const { return ok; } // false once a write has failed
+
+    ReportWriter& operator<<(std::string_view text);
+    ReportWriter& operator<<(const char* text) { return *this << std::string_view(text); }
+    ReportWriter& operator<<(char c);
+    ReportWriter& operator<<(float value); // 6 significant digits, like a default ostream
+    ReportWriter& operator<<(Fixed number);
+    ReportWriter& operator<<(DateTime date);
+
+    // Raw bytes, for binary exports
+    ReportWriter& Write(const void* data, std::size_t size) {
+        return *this << std::string_view(static_cast<const char*>(data), size);
+    }
+
+    template <std::integral T>
+    ReportWriter& operator<<(T value) {
+        Reserve(24);
+        AppendInteger(static_cast<long long>(value));
+        return *this;
+    }
+
+    void Flush();
+
+private:
+    static const std::size_t BUFFER_SIZE = 1 << 20;
+
+    // Makes room for n more bytes, writing the buffer out if needed
+    void Reserve(std::size_t n) {
+        if (BUFFER_SIZE - used < n) Flush();
+    }
+    void AppendInteger(long long value);
+    void WriteOut(const char* data, std::size_t size);
+
+    std::string buffer; // BUFFER_SIZE bytes, the first used of them pending
+    std::size_t used;
+    std::FILE* file;    // standard output or a file this writer opened
+    bool ownsFile;
+    int fd;             // target descriptor when file is null
+    bool ok;
+};
+
+#endif // REPORTWRITER_H
@@ -0,0 +1,44 @@
+#ifndef RESULTCODE_H
+#define RESULTCODE_H
+
+// Outcome of a programmatic (non-interactive) library operation
+enum class ResultCode {
+    OK,
+    PATRON_NOT_FOUND,
+    BOOK_NOT_FOUND,
+    BOOK_NOT_AVAILABLE,
+    OUTSTANDING_FINES,
+    LOAN_LIMIT_REACHED,
+    LOAN_NOT_FOUND,
+    INVALID_FIELD,
+    DUPLICATE_ID,
+    ALREADY_ON_HOLD,  // the patron already has a hold on the title
+    COPY_AVAILABLE,   // a copy is on the shelf, so there is nothing to hold
+    HOLD_NOT_FOUND,
+    HOLDS_WAITING     // a renewal or delete refused because other patrons are waiting for the title
+};
+
+// Number of ResultCode values, for tables indexed by code
+const int RESULT_CODE_COUNT = static_cast<int>(ResultCode::HOLDS_WAITING) + 1;
+
+// Short upper-case name for reports and batch summaries
+inline const char* ResultCodeName(ResultCode code) {
+    switch (code) {
+        case ResultCode::OK: return "OK";
+        case ResultCode::PATRON_NOT_FOUND: return "PATRON_NOT_FOUND";
+        case ResultCode::BOOK_NOT_FOUND: return "BOOK_NOT_FOUND";
+        case ResultCode::BOOK_NOT_AVAILABLE: return "BOOK_NOT_AVAILABLE";
+        case ResultCode::OUTSTANDING_FINES: return "OUTSTANDING_FINES";
+        case ResultCode::LOAN_LIMIT_REACHED: return "LOAN_LIMIT_REACHED";
+        case ResultCode::LOAN_NOT_FOUND: return "LOAN_NOT_FOUND";
+        case ResultCode::INVALID_FIELD: return "INVALID_FIELD";
+        case ResultCode::DUPLICATE_ID: return "DUPLICATE_ID";
+        case ResultCode::ALREADY_ON_HOLD: return "ALREADY_ON_HOLD";
+        case ResultCode::COPY_AVAILABLE: return "COPY_AVAILABLE";
+        case ResultCode::HOLD_NOT_FOUND: return "HOLD_NOT_FOUND";
+        case ResultCode::HOLDS_WAITING: return "HOLDS_WAITING";
+    }
+    return "UNKNOWN";
+}
+
+#endif // RESULTCODE_H
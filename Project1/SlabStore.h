@@ -0,0 +1,144 @@
+#ifndef SLABSTORE_H
+#define SLABSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Handle to a record in a SlabStore. A handle stays valid until its record is
+// erased; after that the slot's generation changes and the handle resolves to nullptr.
+struct SlabHandle {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0; // 0 is never a live generation, so a default handle is null
+
+    bool isNull() const { return generation == 0; }
+    bool operator==(const SlabHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const SlabHandle& other) const { return !(*this == other); }
+};
+
+// Owning store that lays records out contiguously in fixed-size pages.
+// Pages never move, so pointers to records stay valid until the record is erased.
+// Erased slots go on a free list and are reused by the next Emplace.
+template <typename T>
+class SlabStore {
+public:
+    static constexpr std::uint32_t PAGE_SIZE = 1024;
+
+    SlabStore() = default;
+    SlabStore(const SlabStore&) = delete;
+    SlabStore& operator=(const SlabStore&) = delete;
+
+    // Constructs a record in a free slot and returns its handle
+    template <typename... Args>
+    SlabHandle Emplace(Args&&... args) {
+        std::uint32_t index;
+        if (freeHead != NO_SLOT) {
+            index = freeHead;
+            freeHead = slotAt(index).nextFree;
+        } else {
+            if (used % PAGE_SIZE == 0) pages.push_back(std::make_unique<Slot[]>(PAGE_SIZE));
+            index = used++;
+        }
+        Slot& slot = slotAt(index);
+        slot.value.emplace(std::forward<Args>(args)...);
+        slot.nextFree = NO_SLOT;
+        ++count;
+        return SlabHandle{ index, slot.generation };
+    }
+
+    // Destroys the record and recycles its slot. Stale handles are ignored.
+    void Erase(SlabHandle handle) {
+        if (!Get(handle)) return;
+        Slot& slot = slotAt(handle.index);
+        slot.value.reset();
+        if (++slot.generation == 0) slot.generation = 1;
+        slot.nextFree = freeHead;
+        freeHead = handle.index;
+        --count;
+    }
+
+    // Returns the record for a handle, or nullptr if the handle is null or stale
+    T* Get(SlabHandle handle) {
+        if (handle.isNull() || handle.index >= used) return nullptr;
+        Slot& slot = slotAt(handle.index);
+        return (slot.generation == handle.generation && slot.value) ? &*slot.value : nullptr;
+    }
+    const T* Get(SlabHandle handle) const { return const_cast<SlabStore*>(this)->Get(handle); }
+
+    // Handle of a record owned by this store, or a null handle. Costs one range check per page.
+    SlabHandle HandleOf(const T* record) const {
+        const std::less<const void*> before;
+        for (std::size_t p = 0; p < pages.size(); ++p) {
+            const Slot* first = pages[p].get();
+            if (before(record, first) || !before(record, first + PAGE_SIZE)) continue;
+            std::size_t offset = static_cast<std::size_t>(reinterpret_cast<const char*>(record) - reinterpret_cast<const char*>(first));
+            std::uint32_t index = static_cast<std::uint32_t>(p * PAGE_SIZE + offset / sizeof(Slot));
+            const Slot& slot = slotAt(index);
+            if (slot.value && &*slot.value == record) return SlabHandle{ index, slot.generation };
+            break;
+        }
+        return SlabHandle{};
+    }
+
+    // Pre-sizes the page table for count records (pages themselves are still allocated on demand)
+    void Reserve(std::size_t count) { pages.reserve((count + PAGE_SIZE - 1) / PAGE_SIZE); }
+
+    std::size_t Size() const { return count; }
+    bool Empty() const { return count == 0; }
+
+    void Clear() {
+        pages.clear();
+        used = 0;
+        count = 0;
+        freeHead = NO_SLOT;
+    }
+
+    // First live record matching pred, in slot order, or nullptr
+    template <typename Pred>
+    T* FindIf(Pred pred) {
+        for (std::uint32_t i = 0; i < used; ++i) {
+            Slot& slot = slotAt(i);
+            if (slot.value && pred(*slot.value)) return &*slot.value;
+        }
+        return nullptr;
+    }
+
+    // Visits live records in slot order, page by page
+    template <typename Fn>
+    void ForEach(Fn fn) {
+        for (std::uint32_t i = 0; i < used; ++i) {
+            Slot& slot = slotAt(i);
+            if (slot.value) fn(SlabHandle{ i, slot.generation }, *slot.value);
+        }
+    }
+    template <typename Fn>
+    void ForEach(Fn fn) const {
+        for (std::uint32_t i = 0; i < used; ++i) {
+            const Slot& slot = slotAt(i);
+            if (slot.value) fn(SlabHandle{ i, slot.generation }, *slot.value);
+        }
+    }
+
+private:
+    static constexpr std::uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    struct Slot {
+        std::optional<T> value;
+        std::uint32_t generation = 1;
+        std::uint32_t nextFree = NO_SLOT;
+    };
+
+    Slot& slotAt(std::uint32_t index) { return pages[index / PAGE_SIZE][index % PAGE_SIZE]; }
+    const Slot& slotAt(std::uint32_t index) const { return pages[index / PAGE_SIZE][index % PAGE_SIZE]; }
+
+    std::vector<std::unique_ptr<Slot[]>> pages;
+    std::uint32_t used = 0;        // slots handed out so far (high-water mark)
+    std::size_t count = 0;         // live records
+    std::uint32_t freeHead = NO_SLOT;
+};
+
+#endif // SLABSTORE_H
@@ -0,0 +1,63 @@
+#include "StringPool.h"
+#include <array>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+// helpers (file-local)
+namespace {
+
+const std::size_t SHARDS = 16;
+const std::size_t BLOCK_SIZE = 64 * 1024;
+
+struct Shard {
+    std::mutex mutex;
+    std::unordered_set<std::string_view> strings; // views into blocks
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::vector<std::unique_ptr<char[]>> large;   // strings too big to share a block
+    std::size_t blockUsed = BLOCK_SIZE;           // bytes used in blocks.back()
+
+    // Copies s into the arena
+    std::string_view Store(std::string_view s) {
+        if (s.size() > BLOCK_SIZE / 4) {
+            large.push_back(std::make_unique<char[]>(s.size()));
+            std::memcpy(large.back().get(), s.data(), s.size());
+            return std::string_view(large.back().get(), s.size());
+        }
+        if (BLOCK_SIZE - blockUsed < s.size()) {
+            blocks.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+            blockUsed = 0;
+        }
+        char* copy = blocks.back().get() + blockUsed;
+        std::memcpy(copy, s.data(), s.size());
+        blockUsed += s.size();
+        return std::string_view(copy, s.size());
+    }
+};
+
+std::array<Shard, SHARDS> shards;
+
+} // namespace
+
+std::string_view StringPool::Intern(std::string_view s) {
+    const std::size_t hash = std::hash<std::string_view>()(s);
+    Shard& shard = shards[hash % SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.strings.find(s);
+    if (found != shard.strings.end()) return *found;
+    std::string_view stored = shard.Store(s);
+    shard.strings.insert(stored);
+    return stored;
+}
+
+std::size_t StringPool::Size() {
+    std::size_t total = 0;
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.strings.size();
+    }
+    return total;
+}
@@ -0,0 +1,20 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <cstddef>
+#include <string_view>
+
+// Process-wide pool of interned strings. Each distinct string is stored once, in large
+// arena blocks, and never freed, so the returned views stay valid for the life of the
+// program and equal strings share one copy. Used for values that repeat heavily, such as
+// book authors. Safe to call from several threads: the pool is split into shards by
+// hash, each with its own lock, so parallel imports rarely wait on each other.
+class StringPool {
+public:
+    static std::string_view Intern(std::string_view s);
+
+    // Distinct strings interned so far
+    static std::size_t Size();
+};
+
+#endif // STRINGPOOL_H
@@ -0,0 +1,136 @@
+#include "WorkTable.h"
+#include "StringPool.h"
+#include <array>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// helpers (file-local)
+namespace {
+
+const std::size_t SHARDS = 16;
+const std::size_t BLOCK_SIZE = 64 * 1024;
+const std::size_t TITLE_ALIGN = 8; // titles take whole 8-byte units, so a dropped title's chunk fits titles of about its length
+
+// Authors are interned, so they compare and hash by address; titles by content
+struct WorkHash {
+    std::size_t operator()(const Work* work) const {
+        std::size_t hash = std::hash<std::string_view>()(work->title);
+        hash ^= std::hash<const void*>()(work->author.data()) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<std::uint64_t>()(work->isbn) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+};
+
+struct WorkEqual {
+    bool operator()(const Work* a, const Work* b) const {
+        return a->isbn == b->isbn && a->author.data() == b->author.data() && a->title == b->title;
+    }
+};
+
+struct Shard {
+    std::mutex mutex;
+    std::unordered_set<const Work*, WorkHash, WorkEqual> works;
+    std::deque<Work> records;                    // never moves its elements
+    std::vector<Work*> freeRecords;              // records of dropped works
+    std::vector<std::unique_ptr<char[]>> blocks; // title bytes
+    std::size_t blockUsed = BLOCK_SIZE;          // bytes used in blocks.back()
+    std::unordered_map<std::size_t, std::vector<char*>> freeTitles; // rounded size -> dropped chunks
+    std::unordered_map<const char*, std::unique_ptr<char[]>> large; // titles too big to share a block
+
+    // Copies a title into the arena, reusing the chunk of a dropped title of the same
+    // rounded size when there is one
+    std::string_view StoreTitle(std::string_view title) {
+        if (title.empty()) return std::string_view();
+        const std::size_t size = roundUp(title.size());
+        char* copy;
+        if (size > BLOCK_SIZE / 4) {
+            auto owned = std::make_unique<char[]>(title.size());
+            copy = owned.get();
+            large.emplace(copy, std::move(owned));
+        } else if (auto reuse = freeTitles.find(size); reuse != freeTitles.end()) {
+            copy = reuse->second.back();
+            reuse->second.pop_back();
+            if (reuse->second.empty()) freeTitles.erase(reuse);
+        } else {
+            if (BLOCK_SIZE - blockUsed < size) {
+                blocks.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+                blockUsed = 0;
+            }
+            copy = blocks.back().get() + blockUsed;
+            blockUsed += size;
+        }
+        std::memcpy(copy, title.data(), title.size());
+        return std::string_view(copy, title.size());
+    }
+
+    void FreeTitle(std::string_view title) {
+        if (title.empty()) return;
+        const std::size_t size = roundUp(title.size());
+        if (size > BLOCK_SIZE / 4) large.erase(title.data());
+        else freeTitles[size].push_back(const_cast<char*>(title.data()));
+    }
+
+    static std::size_t roundUp(std::size_t size) { return (size + TITLE_ALIGN - 1) & ~(TITLE_ALIGN - 1); }
+};
+
+std::array<Shard, SHARDS> shards;
+
+Shard& shardOf(const Work* work) { return shards[WorkHash()(work) % SHARDS]; }
+
+} // namespace
+
+const Work* WorkTable::Intern(std::string_view author, std::string_view title, std::uint64_t isbn) {
+    const Work key(StringPool::Intern(author), title, isbn);
+    Shard& shard = shardOf(&key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.works.find(&key);
+    if (found != shard.works.end()) {
+        (*found)->copies.fetch_add(1, std::memory_order_relaxed);
+        return *found;
+    }
+    Work* stored;
+    if (!shard.freeRecords.empty()) {
+        stored = shard.freeRecords.back();
+        shard.freeRecords.pop_back();
+        stored->author = key.author;
+        stored->title = shard.StoreTitle(title);
+        stored->isbn = isbn;
+    } else {
+        stored = &shard.records.emplace_back(key.author, shard.StoreTitle(title), isbn);
+    }
+    stored->copies.store(1, std::memory_order_relaxed);
+    shard.works.insert(stored);
+    return stored;
+}
+
+void WorkTable::Acquire(const Work* work) {
+    work->copies.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WorkTable::Release(const Work* work) {
+    // Drop a reference that is not the last without locking
+    std::uint32_t copies = work->copies.load(std::memory_order_relaxed);
+    while (copies > 1) {
+        if (work->copies.compare_exchange_weak(copies, copies - 1, std::memory_order_acq_rel)) return;
+    }
+    Shard& shard = shardOf(work);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (work->copies.fetch_sub(1, std::memory_order_acq_rel) != 1) return; // Intern took it meanwhile
+    shard.works.erase(work);
+    shard.FreeTitle(work->title);
+    shard.freeRecords.push_back(const_cast<Work*>(work));
+}
+std::size_t WorkTable::Size() {
+    std::size_t total = 0;
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.works.size();
+    }
+    return total;
+}
@@ -0,0 +1,43 @@
+#ifndef WORKTABLE_H
+#define WORKTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Bibliographic record of a title, shared by every copy of it
+struct Work {
+    Work(std::string_view author, std::string_view title, std::uint64_t isbn)
+        : author(author), title(title), isbn(isbn), copies(0) {}
+
+    std::string_view author; // interned in the StringPool
+    std::string_view title;
+    std::uint64_t isbn;      // packed (see Books::PackISBN)
+    mutable std::atomic<std::uint32_t> copies; // references held (see WorkTable)
+};
+
+// Process-wide table of works. Each distinct (author, title, ISBN) is stored once, so the
+// forty copies of a bestseller point at one record instead of carrying forty copies of
+// its strings, and two copies are of the same work exactly when their pointers are equal.
+//
+// Works are reference counted: every Books copy holds one reference, and a work whose last
+// copy is edited to another title or deleted is dropped from the table, its record and
+// title bytes reused by later works. Safe to call from several threads: the table is split
+// into shards by hash, each with its own lock. A count only drops to zero under its
+// shard's lock, so Intern never hands out a work that is being freed.
+class WorkTable {
+public:
+    // Finds or stores a work and takes a reference to it
+    static const Work* Intern(std::string_view author, std::string_view title, std::uint64_t isbn);
+
+    // Takes another reference to a work the caller already holds one to
+    static void Acquire(const Work* work);
+    // Drops a reference; the last one frees the work
+    static void Release(const Work* work);
+
+    // Works currently stored
+    static std::size_t Size();
+};
+
+#endif // WORKTABLE_H
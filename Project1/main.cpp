@@ -1,11 +1,44 @@
 #include <iostream>
 #include <limits>
 #include <string>
+#include <vector>
 #include <cctype>
 #include <algorithm>
+#include <cstdint>
+#include <ctime>
 #include "PatronsCollection.h"
 #include "BooksCollection.h"
 #include "LoansCollection.h"
+#include "LibrarySnapshot.h"
+#include "LibraryConfig.h"
+#include "Journal.h"
+#include "LoanArchive.h"
+#include "BatchProcessor.h"
+#include "CatalogImporter.h"
+#include "CatalogExporter.h"
+#include "ReportWriter.h"
+
+// Library data is kept in this snapshot file between runs, with changes since the
+// last snapshot in the journal. The journal is folded into a new snapshot at exit
+// and whenever it grows past JOURNAL_COMPACT_BYTES. Returned loans go to the archive.
+static const char* SNAPSHOT_PATH = "library.snap";
+static const char* JOURNAL_PATH = "library.journal";
+static const char* ARCHIVE_PATH = "library.archive";
+static const char* CONFIG_PATH = "library.conf"; // see LibraryConfig.h
+static const std::uint64_t JOURNAL_COMPACT_BYTES = 64ull * 1024 * 1024;
+
+// Writes a fresh snapshot and empties the journal. Save returns once the snapshot is on
+// disk, and journal records are idempotent, so a crash between the two steps just replays
+// them onto the new snapshot. The archive is flushed first, since until then the journal
+// holds the only copy of its unsealed loans.
+// Call it with no transactions in flight: commits made during it could be truncated away.
+static bool checkpoint(Journal& journal, LoanArchive& archive, PatronsCollection& patrons, BooksCollection& books,
+                       LoansCollection& loans) {
+    journal.Sync();
+    if (!archive.Flush()) return false;
+    if (!LibrarySnapshot::Save(SNAPSHOT_PATH, patrons, books, loans)) return false;
+    return journal.Truncate();
+}
 
 void patronOptions(PatronsCollection& patrons) {
     int choice = -1;
@@ -72,7 +105,7 @@ void patronOptions(PatronsCollection& patrons) {
     } while (choice != 5);
 }
 
-void bookOptions(BooksCollection& books) {
+void bookOptions(BooksCollection& books, LoansCollection& loans) {
     int choice = -1;
     do {
         std::cout << "\n--- Book Options ---\n";
@@ -112,7 +145,7 @@ void bookOptions(BooksCollection& books) {
                 books.EditBook();
                 break;
             case 3:
-                books.DeleteBook();
+                loans.DeleteBook(books);
                 break;
             case 4:
                 books.PrintAllBooks();
@@ -129,12 +162,17 @@ void bookOptions(BooksCollection& books) {
 void loanOptions(LoansCollection& loans, PatronsCollection& patrons, BooksCollection& books) {
     int choice = -1;
     do {
+        // Copies left unclaimed past their pickup deadline move on before anything else is shown
+        loans.ExpireHolds(books, static_cast<std::int64_t>(std::time(nullptr)));
         std::cout << "\n--- Loan Options ---\n";
         std::cout << "1. Check Out Book\n";
         std::cout << "2. Check In Book\n";
         std::cout << "3. List All Overdue Books\n";
         std::cout << "4. List All Checked Out Books\n";
-        std::cout << "5. Return to Main Menu\n";
+        std::cout << "5. Place a Hold\n";
+        std::cout << "6. Cancel a Hold\n";
+        std::cout << "7. Loan History\n";
+        std::cout << "8. Return to Main Menu\n";
         std::cout << "Enter choice: ";
         std::string line;
         std::getline(std::cin, line);
@@ -172,19 +210,135 @@ void loanOptions(LoansCollection& loans, PatronsCollection& patrons, BooksCollec
                 loans.ListAllCheckedOutBooks(books);
                 break;
             case 5:
+                loans.PlaceHoldOnBook(patrons, books);
+                break;
+            case 6:
+                loans.CancelHoldForPatron(patrons, books);
+                break;
+            case 7:
+                loans.LoanHistory(patrons, books);
+                break;
+            case 8:
                 std::cout << "Returning to Main Menu...\n";
                 break;
             default:
                 std::cout << "Invalid choice. Please try again.\n";
         }
-    } while (choice != 5);
+    } while (choice != 8);
 }
 
-int main() {
+// Usage: Project1 [--batch <transactions file> | --import-books <file> | --import-patrons <file>
+//                  | --report-books <file> | --report-patrons <file> | --report-loans <file>
+//                  | --export-books <file> | --export-patrons <file> | --export-loans <file>]
+// Export files are JSON Lines, CSV or binary columnar by extension (.jsonl, .csv, .bin).
+// With an option the file is applied (or the report written) without the menu and the program exits.
+int main(int argc, char* argv[]) {
     PatronsCollection patrons;
     BooksCollection books;
     LoansCollection loans;
 
+    Journal journal;
+    LoanArchive archive;
+    if (!archive.Open(ARCHIVE_PATH)) {
+        std::cout << "Warning: cannot open the loan archive; loan history will not be saved.\n";
+    }
+    loans.SetArchive(&archive);
+
+    // Fines are rebuilt from due dates as loans load, so the policy has to be in place first
+    std::vector<std::string> configProblems;
+    if (!LibraryConfig::Load(CONFIG_PATH, loans, configProblems)) {
+        std::cout << "Warning: cannot read " << CONFIG_PATH << "; using the default settings.\n";
+    }
+    for (const std::string& problem : configProblems) {
+        std::cout << "Warning: " << CONFIG_PATH << " " << problem << " (ignored)\n";
+    }
+
+    // An unreadable snapshot would be replaced by an empty one at the first checkpoint,
+    // so the program stops and leaves it for the user to recover or move away
+    const LibrarySnapshot::LoadResult load = LibrarySnapshot::Load(SNAPSHOT_PATH, patrons, books, loans);
+    if (load == LibrarySnapshot::UNREADABLE) {
+        std::cout << "Error: " << SNAPSHOT_PATH << " is damaged or from another version of this program.\n"
+                  << "Move it away to start with an empty library.\n";
+        return 1;
+    }
+    const bool loaded = load == LibrarySnapshot::LOADED;
+    std::size_t replayed = Journal::Replay(JOURNAL_PATH, patrons, books, loans);
+    if (loaded || replayed > 0) {
+        std::cout << "Loaded " << books.Count() << " book(s), " << patrons.Count() << " patron(s) and "
+                  << loans.Count() << " loan(s).\n";
+    }
+    if (!journal.Open(JOURNAL_PATH)) {
+        std::cout << "Warning: cannot open the journal; changes will only be saved at exit.\n";
+    }
+    if (replayed > 0) checkpoint(journal, archive, patrons, books, loans);
+    patrons.SetJournal(&journal);
+    books.SetJournal(&journal);
+    loans.SetJournal(&journal);
+
+    if (argc == 3) {
+        const std::string option = argv[1];
+        if (option == "--batch") {
+            BatchProcessor batch(patrons, books, loans);
+            BatchProcessor::Summary summary;
+            if (!batch.Run(argv[2], static_cast<std::int64_t>(std::time(nullptr)), summary)) {
+                std::cout << "Cannot read batch file " << argv[2] << ".\n";
+                return 1;
+            }
+            BatchProcessor::PrintSummary(summary);
+        } else if (option == "--import-books" || option == "--import-patrons") {
+            CatalogImporter::Report report;
+            bool read = option == "--import-books" ? CatalogImporter::ImportBooks(argv[2], books, report)
+                                                   : CatalogImporter::ImportPatrons(argv[2], patrons, report);
+            if (!read) {
+                std::cout << "Cannot read import file " << argv[2] << ".\n";
+                return 1;
+            }
+            CatalogImporter::PrintReport(report);
+        } else if (option == "--report-books" || option == "--report-patrons" || option == "--report-loans") {
+            ReportWriter out{ std::string(argv[2]) };
+            if (!out.IsOpen()) {
+                std::cout << "Cannot create report file " << argv[2] << ".\n";
+                return 1;
+            }
+            if (option == "--report-books") books.PrintAllBooks(out);
+            else if (option == "--report-patrons") patrons.PrintAllPatrons(out);
+            else loans.ListAllCheckedOutBooks(books, out);
+            out.Flush();
+            if (!out.Good()) {
+                std::cout << "Cannot write report file " << argv[2] << ".\n";
+                return 1;
+            }
+        } else if (option == "--export-books" || option == "--export-patrons" || option == "--export-loans") {
+            CatalogExporter::Format format;
+            if (!CatalogExporter::FormatForPath(argv[2], format)) {
+                std::cout << "Export file " << argv[2] << " must end in .jsonl, .csv or .bin.\n";
+                return 1;
+            }
+            ReportWriter out{ std::string(argv[2]) };
+            if (!out.IsOpen()) {
+                std::cout << "Cannot create export file " << argv[2] << ".\n";
+                return 1;
+            }
+            std::size_t rows = option == "--export-books" ? CatalogExporter::ExportBooks(books, format, out)
+                             : option == "--export-patrons" ? CatalogExporter::ExportPatrons(patrons, format, out)
+                             : CatalogExporter::ExportLoans(loans, books, format, out);
+            out.Flush();
+            if (!out.Good()) {
+                std::cout << "Cannot write export file " << argv[2] << ".\n";
+                return 1;
+            }
+            std::cout << "Exported " << rows << " row(s).\n";
+        } else {
+            std::cout << "Unknown option " << option << ".\n";
+            return 1;
+        }
+        if (!checkpoint(journal, archive, patrons, books, loans)) {
+            std::cout << "Warning: library data could not be saved.\n";
+            return 1;
+        }
+        return 0;
+    }
+
     int choice = -1;
     do {
         std::cout << "\n--- Library Management System ---\n";
@@ -220,17 +374,21 @@ int main() {
                 patronOptions(patrons);
                 break;
             case 2:
-                bookOptions(books);
+                bookOptions(books, loans);
                 break;
             case 3:
                 loanOptions(loans, patrons, books);
                 break;
             case 4:
+                if (!checkpoint(journal, archive, patrons, books, loans)) {
+                    std::cout << "Warning: library data could not be saved.\n";
+                }
                 std::cout << "Exiting Library Management System. Goodbye!\n";
                 break;
             default:
                 std::cout << "Invalid choice. Please try again.\n";
         }
+        if (journal.SizeBytes() > JOURNAL_COMPACT_BYTES) checkpoint(journal, archive, patrons, books, loans);
     } while (choice != 4);
 
     return 0;